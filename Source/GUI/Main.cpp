@@ -1,10 +1,24 @@
 #include "WebEngine/DOM/Text.hpp"
 #include "WebEngine/HTML/Parser.hpp"
 #include "WebEngine/HTML/Tokenizer.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+#include "WebEngine/Painting/DisplayList.hpp"
+#include "WebEngine/Painting/DisplayListIndex.hpp"
+
+#include "Paint/GlyphCache.hpp"
+#include "Paint/ScrollBlit.hpp"
+#include "Paint/TileRenderer.hpp"
+
+#include "SurfacePool.hpp"
 
 #include <print>
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <thread>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string_view>
 #include <mwl/mwl.hpp>
@@ -14,6 +28,15 @@
 
 using namespace Hanami;
 
+// Redraws are capped to this rate while scrolling continuously, scroll events arriving in between end up in the next frame.
+static constexpr auto MinFrameInterval = std::chrono::microseconds(1'000'000 / 60);
+
+// NOTE: mwl only dispatches the events that are pending without waiting for more, so while idle we wait between polls instead.
+static constexpr auto IdlePollInterval = std::chrono::milliseconds(10);
+
+// Enough tiles for a few screens' worth of the page, so scrolling back and forth doesn't repaint anything.
+static constexpr size_t TileMemoryBudget = 64 * 1024 * 1024;
+
 int main(int argc, char* argv[])
 {
     auto mwl_state = mwl::State::create({ .client_api = mwl::ClientAPI::Wayland });
@@ -28,6 +51,9 @@ int main(int argc, char* argv[])
     double x_scroll = 0.0;
     double y_scroll = 0.0;
 
+    // Set by anything that changes what's on screen, i.e. scrolling, resizing or a change to the document.
+    bool needs_redraw = true;
+
     win.set_mouse_scroll_callback([&](const mwl::MouseScrollEvent& event)
     {
         if (event.axis() == mwl::ScrollAxis::Horizontal)
@@ -38,6 +64,8 @@ int main(int argc, char* argv[])
         {
             y_scroll -= event.value();
         }
+
+        needs_redraw = true;
     });
 
     auto path = "Tests/Parsing/comment-before-html-tag.html"sv;
@@ -67,89 +95,147 @@ int main(int argc, char* argv[])
         document = HTML::Parser{}.parse(ss.str());
     }
 
-    std::vector<DOM::Text*> text_elements;
+    constexpr double font_size = 24.0;
+
+    GlyphCache glyph_cache("serif");
+    SurfacePool surface_pool;
 
-    [&text_elements](this auto&& self, HTML::Node* node) -> void
+    // Brought up to date every frame, which only lays out again what changed in the document or the window's width,
+    // and what scrolled close enough to the viewport to replace its estimated height.
+    // NOTE: Sequential, since only laying out everything goes parallel, and the window only lays out its viewport.
+    Layout::LayoutTree layout_tree([&](std::string_view text)
     {
-        if (node == nullptr)
-        {
-            return;
-        }
+        return glyph_cache.advance(text, font_size);
+    }, { .font_size = font_size, .thread_count = 1 });
 
-        if (auto* text = dynamic_cast<HTML::Text*>(node))
-        {
-            text_elements.emplace_back(text);
-        }
+    // Recorded from the layout tree from where the layout changed down, whenever it does.
+    Painting::DisplayList display_list;
+    Painting::DisplayListIndex display_list_index;
 
-        for (auto* child : node->children())
-        {
-            self(child);
-        }
-    }(document->body());
+    auto drawn_document_version = document->version();
 
-    auto compute_text_for_rendering = [](const HTML::Text* text) -> std::string
-    {
-        std::string result;
+    TileRenderer tile_renderer("serif", TileMemoryBudget);
+    tile_renderer.set_display_list(display_list, display_list_index);
 
-        std::ranges::unique_copy(text->whole_text(), std::back_inserter(result), [](char a, char b)
-        {
-            return std::isspace(a) && std::isspace(b);
-        });
+    // What the last frame drew, so the next one can move its pixels instead of repainting them after a scroll.
+    struct PresentedFrame
+    {
+        const uint8_t* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        int x_scroll = 0;
+        int y_scroll = 0;
+    };
 
-        const auto removed = std::ranges::remove(result, '\n');
-        result.erase(removed.begin(), removed.end());
+    std::optional<PresentedFrame> last_frame;
 
-        return result;
-    };
+    auto last_width = win.width();
+    auto last_height = win.height();
+    auto last_frame_time = std::chrono::steady_clock::time_point{};
 
     while (running)
     {
         mwl_state.dispatch_events();
 
-        auto buffer = win.fetch_screen_buffer();
-        auto* surface = cairo_image_surface_create_for_data(
-            reinterpret_cast<unsigned char*>(&buffer[0]),
-            CAIRO_FORMAT_ARGB32,
-            win.width(), win.height(),
-            cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, win.width()));
+        if (win.width() != last_width || win.height() != last_height)
+        {
+            last_width = win.width();
+            last_height = win.height();
+            needs_redraw = true;
+        }
 
-        auto* cairo_ctx = cairo_create(surface);
+        if (document->version() != drawn_document_version)
+        {
+            drawn_document_version = document->version();
+            needs_redraw = true;
+        }
 
-        // Clear to white
-        cairo_rectangle(cairo_ctx, 0, 0, win.width(), win.height());
-        cairo_set_source_rgb(cairo_ctx, 1, 1, 1);
-        cairo_fill(cairo_ctx);
+        if (!needs_redraw)
+        {
+            std::this_thread::sleep_for(IdlePollInterval);
+            continue;
+        }
 
-        // Draw texts
-        cairo_select_font_face(cairo_ctx, "serif", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+        if (const auto next_frame_time = last_frame_time + MinFrameInterval; std::chrono::steady_clock::now() < next_frame_time)
+        {
+            // Too early for another frame, pick up whatever else arrives until then.
+            std::this_thread::sleep_until(next_frame_time);
+            continue;
+        }
 
-        double x = x_scroll;
-        double y = y_scroll;
+        last_frame_time = std::chrono::steady_clock::now();
+        needs_redraw = false;
 
-        constexpr double font_size = 24.0;
+        auto buffer = win.fetch_screen_buffer();
+        auto* pixels = reinterpret_cast<uint8_t*>(&buffer[0]);
+        const auto width = static_cast<int>(win.width());
+        const auto height = static_cast<int>(win.height());
+        const auto stride = static_cast<size_t>(cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width));
+
+        const auto [surface, cairo_ctx] = surface_pool.target_for(pixels, width, height);
+
+        // NOTE: The scroll offsets move the page, so scrolling down makes them negative.
+        const bool layout_changed = layout_tree.update(*document, Layout::Viewport {
+            .width = static_cast<double>(width),
+            .top = -y_scroll,
+            .height = static_cast<double>(height),
+        });
+
+        // Keeps what was at the top of the viewport in place, e.g. when the boxes above it were laid out for real.
+        y_scroll -= layout_tree.scroll_adjustment();
 
-        cairo_set_font_size(cairo_ctx, font_size);
+        // Where on the page the display list (and the tiles painted from it) changed. Scrolling into estimated
+        // content only changes it below what was on screen.
+        auto repainted_top = std::numeric_limits<double>::infinity();
 
-        for (const auto* text : text_elements)
+        if (layout_changed)
         {
-            auto str = compute_text_for_rendering(text);
+            const auto change = Painting::rerecord_layout_tree(display_list, layout_tree, {}, layout_tree.changed_top());
+            display_list_index.update(display_list, change);
+            tile_renderer.invalidate_from(change.top);
+            repainted_top = change.top;
+        }
 
-            if (str.empty())
-            {
-                continue;
-            }
+        // NOTE: Scrolled by whole pixels, so the pixels of the last frame line up with the new ones.
+        const auto frame = PresentedFrame {
+            .pixels = pixels,
+            .width = width,
+            .height = height,
+            .x_scroll = static_cast<int>(std::lround(x_scroll)),
+            .y_scroll = static_cast<int>(std::lround(y_scroll)),
+        };
+
+        DamagedArea damaged;
+
+        // The last frame's pixels are still in its buffer, so after a scroll only the strips that scrolled into view
+        // have to be painted, unless something changed in what it showed. Anything else means painting everything.
+        if (last_frame && last_frame->width == width && last_frame->height == height &&
+            layout_tree.scroll_adjustment() == 0.0 && repainted_top >= last_frame->height - last_frame->y_scroll)
+        {
+            cairo_surface_flush(surface);
 
-            cairo_move_to(cairo_ctx, x, y + font_size);
-            cairo_set_source_rgb(cairo_ctx, 0, 0, 0);
-            cairo_show_text(cairo_ctx, str.data());
+            damaged = scroll_pixels(
+                last_frame->pixels, pixels,
+                width, height, stride,
+                frame.x_scroll - last_frame->x_scroll,
+                frame.y_scroll - last_frame->y_scroll);
 
-            y += font_size;
+            cairo_surface_mark_dirty(surface);
+        }
+        else
+        {
+            damaged.add({ 0, 0, width, height });
         }
 
-        cairo_surface_finish(surface);
-        cairo_destroy(cairo_ctx);
+        tile_renderer.compose(cairo_ctx, std::span{ damaged.rects.data(), damaged.count }, frame.x_scroll, frame.y_scroll);
+
+        cairo_surface_flush(surface);
 
         win.present_screen_buffer(buffer);
+        last_frame = frame;
+
+        // Paints whatever is about to scroll into view while we wait for the next frame.
+        tile_renderer.prefetch({ 0, 0, width, height }, frame.x_scroll, frame.y_scroll);
     }
 
     return 0;
@@ -0,0 +1,66 @@
+#include "SurfacePool.hpp"
+
+namespace Hanami {
+
+    SurfacePool::~SurfacePool()
+    {
+        clear();
+    }
+
+    auto SurfacePool::target_for(void* data, int width, int height) -> Target
+    {
+        for (auto& entry : m_entries)
+        {
+            if (entry.data != data)
+            {
+                continue;
+            }
+
+            if (entry.width == width && entry.height == height)
+            {
+                cairo_identity_matrix(entry.target.context);
+                cairo_reset_clip(entry.target.context);
+                return entry.target;
+            }
+
+            // The buffers all change size together, none of the others are any good either.
+            clear();
+            break;
+        }
+
+        if (m_entries.size() == MaxEntries)
+        {
+            destroy(m_entries.front());
+            m_entries.erase(m_entries.begin());
+        }
+
+        auto* surface = cairo_image_surface_create_for_data(
+            static_cast<unsigned char*>(data),
+            CAIRO_FORMAT_ARGB32,
+            width, height,
+            cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width));
+
+        const auto target = Target { surface, cairo_create(surface) };
+        m_entries.push_back({ data, width, height, target });
+
+        return target;
+    }
+
+    void SurfacePool::clear()
+    {
+        for (auto& entry : m_entries)
+        {
+            destroy(entry);
+        }
+
+        m_entries.clear();
+    }
+
+    void SurfacePool::destroy(Entry& entry)
+    {
+        cairo_destroy(entry.target.context);
+        cairo_surface_finish(entry.target.surface);
+        cairo_surface_destroy(entry.target.surface);
+    }
+
+}
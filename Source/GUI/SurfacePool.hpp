@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <cairo/cairo.h>
+
+namespace Hanami {
+
+    // A Cairo surface and context for every buffer of the window's swap chain, created the first time a buffer is
+    // drawn into and kept until the window is resized.
+    class SurfacePool
+    {
+    public:
+        struct Target
+        {
+            cairo_surface_t* surface;
+            cairo_t* context;
+        };
+
+        SurfacePool() = default;
+        ~SurfacePool();
+
+        SurfacePool(const SurfacePool&) = delete;
+        auto operator=(const SurfacePool&) -> SurfacePool& = delete;
+
+        // The target drawing into the ARGB32 pixels at data, with the context's transformation and clip reset.
+        // Call cairo_surface_flush() on its surface before presenting the buffer.
+        [[nodiscard]]
+        auto target_for(void* data, int width, int height) -> Target;
+
+        void clear();
+
+    private:
+        // Swap chains are at most triple buffered, anything beyond that are buffers that aren't coming back.
+        static constexpr size_t MaxEntries = 4;
+
+        struct Entry
+        {
+            void* data;
+            int width;
+            int height;
+            Target target;
+        };
+
+        static void destroy(Entry& entry);
+
+        std::vector<Entry> m_entries;
+    };
+
+}
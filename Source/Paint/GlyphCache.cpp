@@ -0,0 +1,143 @@
+#include "GlyphCache.hpp"
+
+namespace Hanami {
+
+    GlyphCache::GlyphCache(const char* family)
+        : m_font_face(cairo_toy_font_face_create(family, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL))
+    {
+    }
+
+    GlyphCache::~GlyphCache()
+    {
+        for (auto& [_, scaled_font] : m_scaled_fonts)
+        {
+            cairo_scaled_font_destroy(scaled_font);
+        }
+
+        cairo_font_face_destroy(m_font_face);
+    }
+
+    auto GlyphCache::scaled_font(double font_size) -> cairo_scaled_font_t*
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (const auto it = m_scaled_fonts.find(font_size); it != m_scaled_fonts.end())
+        {
+            return it->second;
+        }
+
+        cairo_matrix_t font_matrix;
+        cairo_matrix_init_scale(&font_matrix, font_size, font_size);
+
+        cairo_matrix_t ctm;
+        cairo_matrix_init_identity(&ctm);
+
+        auto* options = cairo_font_options_create();
+        auto* scaled_font = cairo_scaled_font_create(m_font_face, &font_matrix, &ctm, options);
+        cairo_font_options_destroy(options);
+
+        m_scaled_fonts.emplace(font_size, scaled_font);
+        return scaled_font;
+    }
+
+    auto GlyphCache::glyph_run(std::string_view text, double font_size) -> const GlyphRun&
+    {
+        {
+            std::shared_lock lock(m_mutex);
+
+            if (const auto it = m_runs.find(RunKeyView{ font_size, text }); it != m_runs.end())
+            {
+                return it->second;
+            }
+        }
+
+        auto* font = scaled_font(font_size);
+
+        GlyphRun run;
+        cairo_glyph_t* glyphs = nullptr;
+        int glyph_count = 0;
+
+        const auto status = cairo_scaled_font_text_to_glyphs(
+            font, 0.0, 0.0,
+            text.data(), static_cast<int>(text.length()),
+            &glyphs, &glyph_count,
+            nullptr, nullptr, nullptr);
+
+        // NOTE: A run that failed to convert stays empty, it's cached all the same so we don't retry every frame.
+        if (status == CAIRO_STATUS_SUCCESS)
+        {
+            run.glyphs.assign(glyphs, glyphs + glyph_count);
+            cairo_glyph_free(glyphs);
+
+            cairo_text_extents_t extents;
+            cairo_scaled_font_glyph_extents(font, run.glyphs.data(), glyph_count, &extents);
+            run.advance = extents.x_advance;
+        }
+
+        std::scoped_lock lock(m_mutex);
+
+        if (m_runs.size() >= MaxRuns)
+        {
+            m_runs.clear();
+        }
+
+        return m_runs.emplace(RunKey{ font_size, std::string{ text } }, std::move(run)).first->second;
+    }
+
+    auto GlyphCache::advance(std::string_view text, double font_size) -> double
+    {
+        {
+            std::shared_lock lock(m_mutex);
+
+            if (const auto it = m_advances.find(RunKeyView{ font_size, text }); it != m_advances.end())
+            {
+                return it->second;
+            }
+
+            if (const auto it = m_runs.find(RunKeyView{ font_size, text }); it != m_runs.end())
+            {
+                return it->second.advance;
+            }
+        }
+
+        auto* font = scaled_font(font_size);
+
+        double advance = 0.0;
+        cairo_glyph_t* glyphs = nullptr;
+        int glyph_count = 0;
+
+        const auto status = cairo_scaled_font_text_to_glyphs(
+            font, 0.0, 0.0,
+            text.data(), static_cast<int>(text.length()),
+            &glyphs, &glyph_count,
+            nullptr, nullptr, nullptr);
+
+        if (status == CAIRO_STATUS_SUCCESS)
+        {
+            cairo_text_extents_t extents;
+            cairo_scaled_font_glyph_extents(font, glyphs, glyph_count, &extents);
+            cairo_glyph_free(glyphs);
+            advance = extents.x_advance;
+        }
+
+        // NOTE: Another thread may have measured the same text meanwhile, with the same result.
+        std::scoped_lock lock(m_mutex);
+
+        if (m_advances.size() >= MaxAdvances)
+        {
+            m_advances.clear();
+        }
+
+        m_advances.emplace(RunKey{ font_size, std::string{ text } }, advance);
+
+        return advance;
+    }
+
+    void GlyphCache::clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_runs.clear();
+        m_advances.clear();
+    }
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <vector>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include <cairo/cairo.h>
+
+namespace Hanami {
+
+    // Text converted to glyphs once, positioned relative to the start of its baseline.
+    struct GlyphRun
+    {
+        std::vector<cairo_glyph_t> glyphs;
+        double advance = 0.0;
+    };
+
+    // Glyph runs of one font face, keyed by font size and text. The face and a scaled font per size are created once
+    // and reused, so drawing a cached run is a single cairo_show_glyphs() without any shaping or UTF-8 decoding.
+    class GlyphCache
+    {
+    public:
+        explicit GlyphCache(const char* family);
+        ~GlyphCache();
+
+        GlyphCache(const GlyphCache&) = delete;
+        auto operator=(const GlyphCache&) -> GlyphCache& = delete;
+
+        [[nodiscard]]
+        auto scaled_font(double font_size) -> cairo_scaled_font_t*;
+
+        // NOTE: The run stays valid until the next call to glyph_run(), which evicts every run once there are too many.
+        [[nodiscard]]
+        auto glyph_run(std::string_view text, double font_size) -> const GlyphRun&;
+
+        // The advance of text without keeping its glyphs, for measuring the many words layout breaks text into.
+        // NOTE: Safe to call from several threads at once, and alongside glyph_run().
+        [[nodiscard]]
+        auto advance(std::string_view text, double font_size) -> double;
+
+        void clear();
+
+    private:
+        struct RunKey
+        {
+            double font_size;
+            std::string text;
+        };
+
+        struct RunKeyView
+        {
+            double font_size;
+            std::string_view text;
+        };
+
+        // Transparent, so lookups don't have to copy the text into a key.
+        struct RunKeyHash
+        {
+            using is_transparent = void;
+
+            auto operator()(const RunKeyView& key) const noexcept -> size_t
+            {
+                return std::hash<std::string_view>{}(key.text) ^ (std::hash<double>{}(key.font_size) << 1);
+            }
+
+            auto operator()(const RunKey& key) const noexcept -> size_t
+            {
+                return (*this)(RunKeyView{ key.font_size, key.text });
+            }
+        };
+
+        struct RunKeyEqual
+        {
+            using is_transparent = void;
+
+            auto operator()(const auto& a, const auto& b) const noexcept -> bool
+            {
+                return a.font_size == b.font_size && std::string_view{ a.text } == std::string_view{ b.text };
+            }
+        };
+
+        // Every page has its own set of words, so rather than growing with every page visited the maps are emptied
+        // whenever they reach these sizes. The words of a page are measured again soon enough.
+        static constexpr size_t MaxRuns = 16 * 1024;
+        static constexpr size_t MaxAdvances = 64 * 1024;
+
+        cairo_font_face_t* m_font_face = nullptr;
+        std::unordered_map<double, cairo_scaled_font_t*> m_scaled_fonts;
+        std::unordered_map<RunKey, GlyphRun, RunKeyHash, RunKeyEqual> m_runs;
+        std::unordered_map<RunKey, double, RunKeyHash, RunKeyEqual> m_advances;
+
+        // Guards all three maps.
+        std::shared_mutex m_mutex;
+    };
+
+}
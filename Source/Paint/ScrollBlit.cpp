@@ -0,0 +1,77 @@
+#include "ScrollBlit.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+namespace Hanami {
+
+    static constexpr size_t BytesPerPixel = 4;
+
+    auto scroll_pixels(const uint8_t* source, uint8_t* target, int width, int height, size_t stride, int dx, int dy) -> DamagedArea
+    {
+        DamagedArea damaged;
+
+        const int copy_width = width - std::abs(dx);
+        const int copy_height = height - std::abs(dy);
+
+        if (copy_width <= 0 || copy_height <= 0)
+        {
+            damaged.add({ 0, 0, width, height });
+            return damaged;
+        }
+
+        const auto row_bytes = static_cast<size_t>(copy_width) * BytesPerPixel;
+        const auto source_x_offset = static_cast<size_t>(std::max(-dx, 0)) * BytesPerPixel;
+        const auto target_x_offset = static_cast<size_t>(std::max(dx, 0)) * BytesPerPixel;
+
+        auto copy_row = [&](int target_y)
+        {
+            const auto source_y = target_y - dy;
+
+            // NOTE: memmove, a row moving sideways within the same buffer overlaps itself.
+            std::memmove(
+                target + static_cast<size_t>(target_y) * stride + target_x_offset,
+                source + static_cast<size_t>(source_y) * stride + source_x_offset,
+                row_bytes);
+        };
+
+        // Rows are copied starting with the one furthest along the direction they move in, so within the same buffer
+        // no row is overwritten before it has been copied.
+        if (dy > 0)
+        {
+            for (int y = height - 1; y >= dy; --y)
+            {
+                copy_row(y);
+            }
+
+            damaged.add({ 0, 0, width, dy });
+        }
+        else
+        {
+            for (int y = 0; y < copy_height; ++y)
+            {
+                copy_row(y);
+            }
+
+            if (dy < 0)
+            {
+                damaged.add({ 0, copy_height, width, -dy });
+            }
+        }
+
+        const int copied_top = std::max(dy, 0);
+
+        if (dx > 0)
+        {
+            damaged.add({ 0, copied_top, dx, copy_height });
+        }
+        else if (dx < 0)
+        {
+            damaged.add({ copy_width, copied_top, -dx, copy_height });
+        }
+
+        return damaged;
+    }
+
+}
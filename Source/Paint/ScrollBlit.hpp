@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace Hanami {
+
+    struct PixelRect
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // The parts of a buffer that still have to be painted, at most one horizontal and one vertical strip after a scroll.
+    struct DamagedArea
+    {
+        std::array<PixelRect, 2> rects{};
+        size_t count = 0;
+
+        void add(const PixelRect& rect) noexcept { rects[count++] = rect; }
+    };
+
+    // Copies the 32-bit pixels of source into target moved by (dx, dy), source and target may be the same buffer.
+    // Returns the area of target the pixels didn't cover, i.e. everything if the move was at least a buffer's size.
+    auto scroll_pixels(const uint8_t* source, uint8_t* target, int width, int height, size_t stride, int dx, int dy) -> DamagedArea;
+
+}
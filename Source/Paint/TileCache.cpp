@@ -0,0 +1,99 @@
+#include "TileCache.hpp"
+
+#include <algorithm>
+
+namespace Hanami {
+
+    TileCache::TileCache(size_t memory_budget)
+        : m_max_tiles(std::max<size_t>(memory_budget / TileBytes, 1))
+    {
+    }
+
+    TileCache::~TileCache()
+    {
+        invalidate();
+
+        for (auto& tile : m_free_tiles)
+        {
+            destroy(tile);
+        }
+    }
+
+    auto TileCache::find(const TileKey& key) -> const Tile*
+    {
+        const auto it = m_lookup.find(key);
+
+        if (it == m_lookup.end())
+        {
+            return nullptr;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->tile;
+    }
+
+    auto TileCache::insert(const TileKey& key) -> const Tile&
+    {
+        Tile tile;
+
+        if (!m_free_tiles.empty())
+        {
+            tile = m_free_tiles.back();
+            m_free_tiles.pop_back();
+        }
+        else if (m_entries.size() >= m_max_tiles)
+        {
+            auto& evicted = m_entries.back();
+            tile = evicted.tile;
+            m_lookup.erase(evicted.key);
+            m_entries.pop_back();
+        }
+        else
+        {
+            auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, TileSize, TileSize);
+            tile = { surface, cairo_create(surface) };
+        }
+
+        cairo_identity_matrix(tile.context);
+        cairo_reset_clip(tile.context);
+
+        m_entries.push_front({ key, tile });
+        m_lookup.insert_or_assign(key, m_entries.begin());
+
+        return m_entries.front().tile;
+    }
+
+    void TileCache::invalidate()
+    {
+        for (auto& entry : m_entries)
+        {
+            m_free_tiles.push_back(entry.tile);
+        }
+
+        m_entries.clear();
+        m_lookup.clear();
+    }
+
+    void TileCache::invalidate_from(int row)
+    {
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (it->key.row < row)
+            {
+                ++it;
+                continue;
+            }
+
+            m_free_tiles.push_back(it->tile);
+            m_lookup.erase(it->key);
+            it = m_entries.erase(it);
+        }
+    }
+
+    void TileCache::destroy(Tile& tile)
+    {
+        cairo_destroy(tile.context);
+        cairo_surface_destroy(tile.surface);
+    }
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <list>
+#include <vector>
+#include <cstddef>
+#include <unordered_map>
+
+#include <cairo/cairo.h>
+
+namespace Hanami {
+
+    // A tile of the page, in units of TileCache::TileSize from the top left of the page.
+    struct TileKey
+    {
+        int column;
+        int row;
+
+        auto operator==(const TileKey&) const -> bool = default;
+    };
+
+    struct TileKeyHash
+    {
+        auto operator()(const TileKey& key) const noexcept -> size_t
+        {
+            return std::hash<int>{}(key.column) ^ (std::hash<int>{}(key.row) << 1);
+        }
+    };
+
+    // Rasterized tiles of the page, each an ARGB32 surface with a context drawing into it. The least recently used
+    // tiles are evicted once the tiles take up more than the memory budget, and their surfaces go to the next tiles.
+    class TileCache
+    {
+    public:
+        static constexpr int TileSize = 256;
+        static constexpr size_t TileBytes = static_cast<size_t>(TileSize) * TileSize * 4;
+
+        struct Tile
+        {
+            cairo_surface_t* surface;
+            cairo_t* context;
+        };
+
+        explicit TileCache(size_t memory_budget);
+        ~TileCache();
+
+        TileCache(const TileCache&) = delete;
+        auto operator=(const TileCache&) -> TileCache& = delete;
+
+        // The cached tile, marked as the most recently used one. Null if the tile isn't cached.
+        [[nodiscard]]
+        auto find(const TileKey& key) -> const Tile*;
+
+        // Adds a tile for key, which the caller has to paint, evicting the least recently used tiles if the budget
+        // is used up. Its context's transformation and clip are reset, the pixels are whatever a previous tile left.
+        [[nodiscard]]
+        auto insert(const TileKey& key) -> const Tile&;
+
+        // Drops every tile, e.g. after the layout changed. The surfaces are kept around for the tiles painted next.
+        void invalidate();
+
+        // Drops the tiles from the row on, e.g. after the layout changed from there down.
+        void invalidate_from(int row);
+
+        [[nodiscard]]
+        auto memory_used() const noexcept -> size_t { return (m_entries.size() + m_free_tiles.size()) * TileBytes; }
+
+    private:
+        struct Entry
+        {
+            TileKey key;
+            Tile tile;
+        };
+
+        static void destroy(Tile& tile);
+
+        size_t m_max_tiles;
+
+        // Most recently used first.
+        std::list<Entry> m_entries;
+        std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> m_lookup;
+
+        std::vector<Tile> m_free_tiles;
+    };
+
+}
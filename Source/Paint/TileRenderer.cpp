@@ -0,0 +1,237 @@
+#include "TileRenderer.hpp"
+
+#include <Kori/Core.hpp>
+
+#include <cmath>
+#include <algorithm>
+
+namespace Hanami {
+
+    static constexpr int TileSize = TileCache::TileSize;
+
+    static auto floor_div(int value, int divisor) -> int
+    {
+        return value / divisor - (value % divisor < 0 ? 1 : 0);
+    }
+
+    static auto tile_rect(const TileKey& key) -> Painting::Rect
+    {
+        return {
+            static_cast<double>(key.column * TileSize),
+            static_cast<double>(key.row * TileSize),
+            static_cast<double>(TileSize),
+            static_cast<double>(TileSize),
+        };
+    }
+
+    // Replays the given commands (in painting order) that intersect the viewport, which is given in page coordinates
+    // and ends up at the origin of the context.
+    static void replay_display_list(
+        cairo_t* cairo_ctx,
+        GlyphCache& glyph_cache,
+        const Painting::DisplayList& list,
+        std::span<const uint32_t> command_indices,
+        const Painting::Rect& viewport)
+    {
+        cairo_save(cairo_ctx);
+        cairo_translate(cairo_ctx, -viewport.x, -viewport.y);
+
+        const auto commands = list.commands();
+        const auto bounds = list.command_bounds();
+
+        for (const auto i : command_indices)
+        {
+            if (!bounds[i].intersects(viewport))
+            {
+                continue;
+            }
+
+            std::visit(Kori::VariantOverloadSet {
+                [&](const Painting::FillRectCommand& command)
+                {
+                    cairo_rectangle(cairo_ctx, command.rect.x, command.rect.y, command.rect.width, command.rect.height);
+                    cairo_set_source_rgba(cairo_ctx, command.color.r, command.color.g, command.color.b, command.color.a);
+                    cairo_fill(cairo_ctx);
+                },
+                [&](const Painting::DrawTextCommand& command)
+                {
+                    const auto& run = glyph_cache.glyph_run(list.text(command), command.font_size);
+
+                    cairo_set_scaled_font(cairo_ctx, glyph_cache.scaled_font(command.font_size));
+                    cairo_set_source_rgba(cairo_ctx, command.color.r, command.color.g, command.color.b, command.color.a);
+
+                    // The glyphs are positioned relative to the start of the baseline.
+                    cairo_translate(cairo_ctx, command.x, command.baseline);
+                    cairo_show_glyphs(cairo_ctx, run.glyphs.data(), static_cast<int>(run.glyphs.size()));
+                    cairo_translate(cairo_ctx, -command.x, -command.baseline);
+                }
+            }, commands[i]);
+        }
+
+        cairo_restore(cairo_ctx);
+    }
+
+    TileRenderer::TileRenderer(const char* font_family, size_t memory_budget, uint32_t thread_count)
+        : m_tiles(memory_budget)
+        , m_pool(thread_count)
+    {
+        m_workers.reserve(m_pool.thread_count());
+
+        for (uint32_t i = 0; i < m_pool.thread_count(); ++i)
+        {
+            m_workers.emplace_back(std::make_unique<Worker>(font_family));
+        }
+    }
+
+    TileRenderer::~TileRenderer()
+    {
+        // Prefetched tiles may still be painting.
+        m_pool.wait();
+    }
+
+    void TileRenderer::set_display_list(const Painting::DisplayList& list, const Painting::DisplayListIndex& index)
+    {
+        m_pool.wait();
+
+        m_display_list = &list;
+        m_display_list_index = &index;
+        m_tiles.invalidate();
+    }
+
+    void TileRenderer::invalidate_from(double top)
+    {
+        if (!std::isfinite(top))
+        {
+            return;
+        }
+
+        // Whatever is being prefetched may be painted from the old commands.
+        m_pool.wait();
+
+        m_tiles.invalidate_from(static_cast<int>(std::floor(top / TileCache::TileSize)));
+    }
+
+    void TileRenderer::compose(cairo_t* target, std::span<const PixelRect> areas, int x_scroll, int y_scroll)
+    {
+        // Whatever was prefetched has to be done before its tiles can be copied, or evicted.
+        m_pool.wait();
+
+        for (const auto& area : areas)
+        {
+            for_each_tile(area, x_scroll, y_scroll, [&](const TileKey& key, int, int)
+            {
+                schedule_tile(key);
+            });
+        }
+
+        m_pool.wait();
+
+        cairo_save(target);
+
+        // NOTE: Tiles are copied rather than blended, they're opaque and line up with whole pixels of the target.
+        cairo_set_operator(target, CAIRO_OPERATOR_SOURCE);
+
+        for (const auto& area : areas)
+        {
+            cairo_save(target);
+            cairo_rectangle(target, area.x, area.y, area.width, area.height);
+            cairo_clip(target);
+
+            for_each_tile(area, x_scroll, y_scroll, [&](const TileKey& key, int x, int y)
+            {
+                cairo_rectangle(target, x, y, TileSize, TileSize);
+
+                if (const auto* tile = has_content(key) ? m_tiles.find(key) : nullptr)
+                {
+                    cairo_set_source_surface(target, tile->surface, x, y);
+                }
+                else
+                {
+                    cairo_set_source_rgb(target, 1, 1, 1);
+                }
+
+                cairo_fill(target);
+            });
+
+            cairo_restore(target);
+        }
+
+        cairo_restore(target);
+    }
+
+    void TileRenderer::prefetch(const PixelRect& viewport, int x_scroll, int y_scroll)
+    {
+        m_pool.wait();
+
+        const auto ring = PixelRect {
+            viewport.x - TileSize,
+            viewport.y - TileSize,
+            viewport.width + 2 * TileSize,
+            viewport.height + 2 * TileSize,
+        };
+
+        // NOTE: The visible tiles are cached already, only the ones bordering them end up being painted.
+        for_each_tile(ring, x_scroll, y_scroll, [&](const TileKey& key, int, int)
+        {
+            schedule_tile(key);
+        });
+    }
+
+    void TileRenderer::for_each_tile(const PixelRect& area, int x_scroll, int y_scroll, const auto& func)
+    {
+        // Scrolling moves the page, so the area is at the negated scroll offset in page coordinates.
+        const int page_left = area.x - x_scroll;
+        const int page_top = area.y - y_scroll;
+
+        const int first_column = floor_div(page_left, TileSize);
+        const int last_column = floor_div(page_left + area.width - 1, TileSize);
+        const int first_row = floor_div(page_top, TileSize);
+        const int last_row = floor_div(page_top + area.height - 1, TileSize);
+
+        for (int row = first_row; row <= last_row; ++row)
+        {
+            for (int column = first_column; column <= last_column; ++column)
+            {
+                func(TileKey{ column, row }, column * TileSize + x_scroll, row * TileSize + y_scroll);
+            }
+        }
+    }
+
+    auto TileRenderer::has_content(const TileKey& key) const noexcept -> bool
+    {
+        return m_display_list && tile_rect(key).intersects(m_display_list->bounds());
+    }
+
+    void TileRenderer::schedule_tile(const TileKey& key)
+    {
+        if (!has_content(key) || m_tiles.find(key))
+        {
+            return;
+        }
+
+        // NOTE: The tile is in the cache from here on, the pool is waited for before anyone copies from it.
+        const auto& tile = m_tiles.insert(key);
+
+        m_pool.submit([this, &tile, key]
+        {
+            paint_tile(*m_workers[*ThreadPool::current_worker_index()], tile, key);
+        });
+    }
+
+    void TileRenderer::paint_tile(Worker& worker, const TileCache::Tile& tile, const TileKey& key) const
+    {
+        // Clear to white
+        cairo_set_source_rgb(tile.context, 1, 1, 1);
+        cairo_paint(tile.context);
+
+        const auto viewport = tile_rect(key);
+
+        worker.tile_commands.clear();
+        m_display_list_index->query(viewport.y, viewport.y + viewport.height, worker.tile_commands);
+
+        replay_display_list(tile.context, worker.glyph_cache, *m_display_list, worker.tile_commands, viewport);
+
+        cairo_surface_flush(tile.surface);
+    }
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "WebEngine/Painting/DisplayList.hpp"
+#include "WebEngine/Painting/DisplayListIndex.hpp"
+#include "WebEngine/Core/ThreadPool.hpp"
+
+#include "GlyphCache.hpp"
+#include "TileCache.hpp"
+#include "ScrollBlit.hpp"
+
+#include <span>
+
+namespace Hanami {
+
+    // Rasterizes the display list into tiles of the page and puts frames together from them. Tiles stay cached across
+    // frames, so scrolling only paints tiles that haven't been on screen (recently), until the layout changes where
+    // they are.
+    //
+    // Tiles are painted on a thread pool, every tile into its own surface with its own context. The workers share the
+    // display list read-only and each have their own glyph cache, since glyph caches aren't thread-safe.
+    //
+    // NOTE: The memory budget has to hold the tiles of a whole screen and the ring around it, a tile evicted while
+    //       it's being painted would end up painted twice at once.
+    class TileRenderer
+    {
+    public:
+        // A thread count of 0 uses one thread per hardware thread.
+        TileRenderer(const char* font_family, size_t memory_budget, uint32_t thread_count = 0);
+        ~TileRenderer();
+
+        // NOTE: The list and index are referenced, not copied, and must outlive their use by the renderer.
+        //       Drops all the tiles painted from the previous list.
+        void set_display_list(const Painting::DisplayList& list, const Painting::DisplayListIndex& index);
+
+        // Drops the tiles reaching below top on the page, after the part of the display list there was re-recorded
+        // (see Painting::rerecord_layout_tree()). The tiles above it stay cached.
+        void invalidate_from(double top);
+
+        // Copies the tiles under the areas of the target with the page scrolled to (x_scroll, y_scroll). The ones
+        // that aren't cached are painted first, in parallel.
+        void compose(cairo_t* target, std::span<const PixelRect> areas, int x_scroll, int y_scroll);
+
+        // Starts painting the tiles bordering the viewport that aren't cached yet, so they're ready once they
+        // scroll into view. Doesn't wait for them, the next call to the renderer does.
+        void prefetch(const PixelRect& viewport, int x_scroll, int y_scroll);
+
+    private:
+        struct Worker
+        {
+            explicit Worker(const char* font_family) : glyph_cache(font_family) {}
+
+            GlyphCache glyph_cache;
+            std::vector<uint32_t> tile_commands;
+        };
+
+        // Calls func with every tile overlapping area, along with where it goes in the target.
+        static void for_each_tile(const PixelRect& area, int x_scroll, int y_scroll, const auto& func);
+
+        // Most of the page around the content is blank, which isn't worth a tile.
+        [[nodiscard]]
+        auto has_content(const TileKey& key) const noexcept -> bool;
+
+        // Queues the tile for painting unless it's cached already.
+        void schedule_tile(const TileKey& key);
+
+        void paint_tile(Worker& worker, const TileCache::Tile& tile, const TileKey& key) const;
+
+        TileCache m_tiles;
+
+        const Painting::DisplayList* m_display_list = nullptr;
+        const Painting::DisplayListIndex* m_display_list_index = nullptr;
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+
+        // NOTE: Last, so the workers are joined before anything they use is destroyed.
+        ThreadPool m_pool;
+    };
+
+}
@@ -0,0 +1,155 @@
+#include "WebEngine/HTML/BatchParser.hpp"
+
+#include <print>
+#include <charconv>
+#include <string_view>
+
+using namespace Hanami;
+using namespace std::literals;
+
+static void print_usage()
+{
+    std::println("Usage: hanami-parse [options] <file or directory>...");
+    std::println("Parses every .html/.htm file given (directories are searched recursively) and reports the throughput.");
+    std::println();
+    std::println("Options:");
+    std::println("  -j, --threads <count>   Number of parser threads, defaults to one per hardware thread");
+    std::println("  --pipelined             Run each document's tokenizer on its own thread");
+    std::println("  --generic-tokenizer     Don't specialize the tokenizer for the input (i.e. one without NUL handling)");
+    std::println("  --compare-tokenizers    Parse everything with the generic and the specialized tokenizer a few times, and compare the fastest runs");
+}
+
+static void print_stats(const HTML::BatchParseStats& stats)
+{
+    std::println("Parsed {} documents ({} failed), {} bytes, {} nodes in {:.3f}s", stats.documents, stats.failed_documents, stats.bytes, stats.nodes, stats.elapsed.count());
+    std::println("{:.2f} MB/s, {:.2f} documents/s, {:.0f} nodes/s", stats.megabytes_per_second(), stats.documents_per_second(), stats.nodes_per_second());
+}
+
+static auto is_html_file(const std::filesystem::path& path) -> bool
+{
+    return path.extension() == ".html" || path.extension() == ".htm";
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::filesystem::path> paths;
+    HTML::ParseOptions options{};
+    uint32_t thread_count = 0;
+    bool compare_tokenizers = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = std::string_view{ argv[i] };
+
+        if (arg == "-h"sv || arg == "--help"sv)
+        {
+            print_usage();
+            return 0;
+        }
+
+        if (arg == "-j"sv || arg == "--threads"sv)
+        {
+            if (i + 1 >= argc)
+            {
+                print_usage();
+                return 1;
+            }
+
+            const auto count = std::string_view{ argv[++i] };
+
+            if (std::from_chars(count.data(), count.data() + count.length(), thread_count).ec != std::errc{})
+            {
+                std::println("Invalid thread count '{}'", count);
+                return 1;
+            }
+
+            continue;
+        }
+
+        if (arg == "--pipelined"sv)
+        {
+            options.pipelined = true;
+            continue;
+        }
+
+        if (arg == "--generic-tokenizer"sv)
+        {
+            options.specialize_tokenizer = false;
+            continue;
+        }
+
+        if (arg == "--compare-tokenizers"sv)
+        {
+            compare_tokenizers = true;
+            continue;
+        }
+
+        const auto path = std::filesystem::path{ arg };
+        std::error_code error;
+
+        if (std::filesystem::is_directory(path, error))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+            {
+                if (entry.is_regular_file() && is_html_file(entry.path()))
+                {
+                    paths.push_back(entry.path());
+                }
+            }
+        }
+        else
+        {
+            paths.push_back(path);
+        }
+    }
+
+    if (paths.empty())
+    {
+        print_usage();
+        return 1;
+    }
+
+    if (compare_tokenizers)
+    {
+        // NOTE: A warm-up run fills the file cache, then the two alternate which one goes first in every round so
+        //       neither always runs right after the other. The fastest round of each is compared.
+        static constexpr size_t Rounds = 3;
+
+        (void)HTML::parse_batch(paths, options, thread_count);
+
+        HTML::BatchParseStats generic{ .elapsed = std::chrono::duration<double>::max() };
+        HTML::BatchParseStats specialized{ .elapsed = std::chrono::duration<double>::max() };
+
+        auto run = [&](bool specialize, HTML::BatchParseStats& best)
+        {
+            options.specialize_tokenizer = specialize;
+            const auto stats = HTML::parse_batch(paths, options, thread_count);
+
+            if (stats.elapsed < best.elapsed)
+            {
+                best = stats;
+            }
+        };
+
+        for (size_t round = 0; round < Rounds; ++round)
+        {
+            run(round % 2 != 0, round % 2 != 0 ? specialized : generic);
+            run(round % 2 == 0, round % 2 == 0 ? specialized : generic);
+        }
+
+        std::println("Generic tokenizer:");
+        print_stats(generic);
+        std::println("Specialized tokenizer:");
+        print_stats(specialized);
+
+        const auto speedup = specialized.elapsed.count() > 0.0 ? generic.elapsed.count() / specialized.elapsed.count() : 0.0;
+        std::println("Speedup: {:.2f}x", speedup);
+
+        return specialized.failed_documents == 0 ? 0 : 1;
+    }
+
+    const auto stats = HTML::parse_batch(paths, options, thread_count);
+    print_stats(stats);
+
+    return stats.failed_documents == 0 ? 0 : 1;
+}
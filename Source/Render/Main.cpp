@@ -0,0 +1,380 @@
+#include "WebEngine/CSS/Parser.hpp"
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/HTML/PreloadScanner.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+#include "WebEngine/Painting/DisplayList.hpp"
+#include "WebEngine/Painting/DisplayListIndex.hpp"
+
+#include "Paint/GlyphCache.hpp"
+#include "Paint/TileRenderer.hpp"
+
+#include <print>
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include <future>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include <Kori/Core.hpp>
+
+#include <cairo/cairo.h>
+
+using namespace Hanami;
+using namespace std::literals;
+
+static constexpr double FontSize = 24.0;
+
+// The bands the page is painted in are sized to this, see paint_page().
+static constexpr size_t TileMemoryBudget = 64 * 1024 * 1024;
+
+static void print_usage()
+{
+    std::println("Usage: hanami-render [options] <file>");
+    std::println("Lays out and paints a document without a window, and reports how long every stage took.");
+    std::println();
+    std::println("Options:");
+    std::println("  -o, --output <file>     Write the image to a .png or .ppm file");
+    std::println("  --width <pixels>        Width of the viewport, defaults to 1920");
+    std::println("  --height <pixels>       Height of the viewport, defaults to 1080");
+    std::println("  --full-page             Paint the whole page instead of the first viewport");
+    std::println("  -j, --threads <count>   Number of layout and painting threads, defaults to one per hardware thread");
+}
+
+// A resource the document references, read while the document is being parsed.
+struct Resource
+{
+    HTML::PreloadRequest::Kind kind;
+    std::string url;
+    std::string data;
+};
+
+// Where url points to on the disk, relative to base_directory. Root-relative URLs are resolved against base_directory
+// too, there's no site root to resolve them against. std::nullopt for URLs leading out of base_directory.
+static auto resolve_resource_path(const std::filesystem::path& base_directory, std::string_view url) -> std::optional<std::filesystem::path>
+{
+    url = url.substr(0, url.find_first_of("?#"));
+    url.remove_prefix(std::min(url.find_first_not_of('/'), url.length()));
+
+    const auto directory = (base_directory.empty() ? std::filesystem::path{ "." } : base_directory).lexically_normal();
+    auto path = (directory / url).lexically_normal();
+
+    if (const auto relative = path.lexically_relative(directory); relative.empty() || *relative.begin() == "..")
+    {
+        return std::nullopt;
+    }
+
+    return path;
+}
+
+// Reads the resources pushed onto queue from the disk, relative to base_directory, until the queue is closed. There's no
+// networking, so URLs with a scheme are skipped.
+static auto load_resources(HTML::PreloadQueue& queue, const std::filesystem::path& base_directory) -> std::vector<Resource>
+{
+    std::vector<Resource> resources;
+
+    while (auto request = queue.pop())
+    {
+        const auto url = std::string_view{ request->url };
+
+        if (url.find(':') != std::string_view::npos)
+        {
+            continue;
+        }
+
+        const auto path = resolve_resource_path(base_directory, url);
+
+        if (!path)
+        {
+            continue;
+        }
+
+        std::ifstream stream(*path, std::ios::binary);
+
+        if (!stream)
+        {
+            continue;
+        }
+
+        std::stringstream ss;
+        ss << stream.rdbuf();
+        resources.push_back({ request->kind, std::move(request->url), std::move(ss).str() });
+    }
+
+    return resources;
+}
+
+static auto parse_number(std::string_view text, auto& out) -> bool
+{
+    return std::from_chars(text.data(), text.data() + text.length(), out).ec == std::errc{};
+}
+
+static auto milliseconds_since(std::chrono::steady_clock::time_point start) -> double
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Paints the page in bands of as many rows of tiles as fit in the tile cache at this width, so no single batch of tiles
+// can outgrow it.
+static void paint_page(TileRenderer& renderer, cairo_t* cairo_ctx, int width, int height)
+{
+    const auto columns = static_cast<size_t>((width + TileCache::TileSize - 1) / TileCache::TileSize);
+    const auto rows = std::max<size_t>(TileMemoryBudget / (columns * TileCache::TileBytes), 1);
+    const auto band_height = static_cast<int>(rows) * TileCache::TileSize;
+
+    for (int y = 0; y < height; y += band_height)
+    {
+        const auto band = PixelRect{ 0, y, width, std::min(band_height, height - y) };
+        renderer.compose(cairo_ctx, std::span{ &band, 1 }, 0, 0);
+    }
+}
+
+// Binary PPM, the pixels are opaque so the alpha channel is simply dropped.
+static auto write_ppm(cairo_surface_t* surface, const std::filesystem::path& path) -> bool
+{
+    std::ofstream stream(path, std::ios::binary);
+
+    if (!stream)
+    {
+        return false;
+    }
+
+    const auto width = cairo_image_surface_get_width(surface);
+    const auto height = cairo_image_surface_get_height(surface);
+    const auto stride = static_cast<size_t>(cairo_image_surface_get_stride(surface));
+    const auto* data = cairo_image_surface_get_data(surface);
+
+    stream << "P6\n" << width << ' ' << height << "\n255\n";
+
+    std::vector<char> row(static_cast<size_t>(width) * 3);
+
+    for (int y = 0; y < height; ++y)
+    {
+        // NOTE: ARGB32 pixels are native-endian 32-bit values, not bytes in a fixed order.
+        const auto* pixels = reinterpret_cast<const uint32_t*>(data + static_cast<size_t>(y) * stride);
+
+        for (int x = 0; x < width; ++x)
+        {
+            row[x * 3 + 0] = static_cast<char>((pixels[x] >> 16) & 0xFF);
+            row[x * 3 + 1] = static_cast<char>((pixels[x] >> 8) & 0xFF);
+            row[x * 3 + 2] = static_cast<char>(pixels[x] & 0xFF);
+        }
+
+        stream.write(row.data(), static_cast<std::streamsize>(row.size()));
+    }
+
+    return static_cast<bool>(stream);
+}
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::path input_path;
+    std::filesystem::path output_path;
+    int width = 1920;
+    int height = 1080;
+    bool full_page = false;
+    uint32_t thread_count = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const auto arg = std::string_view{ argv[i] };
+
+        if (arg == "-h"sv || arg == "--help"sv)
+        {
+            print_usage();
+            return 0;
+        }
+
+        if (arg == "--full-page"sv)
+        {
+            full_page = true;
+            continue;
+        }
+
+        const bool takes_value = arg == "-o"sv || arg == "--output"sv || arg == "--width"sv || arg == "--height"sv ||
+                                 arg == "-j"sv || arg == "--threads"sv;
+
+        if (!takes_value)
+        {
+            input_path = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            print_usage();
+            return 1;
+        }
+
+        const auto value = std::string_view{ argv[++i] };
+
+        if (arg == "-o"sv || arg == "--output"sv)
+        {
+            output_path = value;
+        }
+        else if (arg == "-j"sv || arg == "--threads"sv)
+        {
+            if (!parse_number(value, thread_count))
+            {
+                std::println("Invalid thread count '{}'", value);
+                return 1;
+            }
+        }
+        else if (!parse_number(value, arg == "--width"sv ? width : height) || width <= 0 || height <= 0)
+        {
+            std::println("Invalid size '{}'", value);
+            return 1;
+        }
+    }
+
+    if (input_path.empty())
+    {
+        print_usage();
+        return 1;
+    }
+
+    if (!output_path.empty() && output_path.extension() != ".png" && output_path.extension() != ".ppm")
+    {
+        std::println("Unsupported output format '{}', expected .png or .ppm", output_path.extension().string());
+        return 1;
+    }
+
+    std::string html;
+    {
+        std::ifstream stream(input_path, std::ios::binary);
+
+        if (!stream)
+        {
+            std::println("Failed reading html file. Does the file exist?");
+            return 1;
+        }
+
+        std::stringstream ss;
+        ss << stream.rdbuf();
+        html = std::move(ss).str();
+    }
+
+    // Parse
+    // NOTE: The resources are read on a thread of their own while the document is being parsed, like a browser starts
+    //       fetching them before the parser gets to the elements referencing them.
+    HTML::PreloadQueue preload_queue;
+    auto loaded_resources = std::async(std::launch::async, load_resources, std::ref(preload_queue), input_path.parent_path());
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    auto document = std::unique_ptr<DOM::Document>(HTML::Parser{}.parse(html, { .preload_queue = &preload_queue }));
+
+    const auto parse_ms = milliseconds_since(start_time);
+    const auto resources = loaded_resources.get();
+
+    // Style
+    // NOTE: Only the linked style sheets are parsed here, the ones in <style> elements were parsed along with the
+    //       document. There's no cascade to compute styles from them yet.
+    start_time = std::chrono::steady_clock::now();
+
+    std::vector<CSS::StyleSheet> style_sheets;
+
+    for (const auto& resource : resources)
+    {
+        if (resource.kind == HTML::PreloadRequest::Kind::Stylesheet)
+        {
+            style_sheets.push_back(CSS::Parser::parse_style_sheet(resource.data));
+        }
+    }
+
+    const auto style_ms = milliseconds_since(start_time);
+
+    // Layout
+    // NOTE: There's no style pass yet, every text is laid out in the same font.
+    GlyphCache glyph_cache("serif");
+    Painting::DisplayList display_list;
+    Painting::DisplayListIndex display_list_index;
+
+    // NOTE: Created outside of the timed layout for the same reason as the painting threads below.
+    Layout::LayoutTree layout_tree([&](std::string_view text)
+    {
+        return glyph_cache.advance(text, FontSize);
+    }, { .font_size = FontSize, .thread_count = thread_count });
+
+    start_time = std::chrono::steady_clock::now();
+
+    // NOTE: Only the first viewport is laid out unless the whole page is painted, the same as the GUI's first frame.
+    if (full_page)
+    {
+        (void)layout_tree.update(*document, width);
+    }
+    else
+    {
+        (void)layout_tree.update(*document, Layout::Viewport{ .width = static_cast<double>(width), .height = static_cast<double>(height) });
+    }
+
+    Painting::record_layout_tree(display_list, layout_tree, {});
+    display_list_index.build(display_list);
+
+    const auto layout_ms = milliseconds_since(start_time);
+
+    // Paint
+    const auto page_bounds = display_list.bounds();
+    const auto image_height = full_page
+        ? std::max(height, static_cast<int>(std::ceil(page_bounds.y + page_bounds.height)))
+        : height;
+
+    // NOTE: The thread pool is started outside of the timed paint, it's created once per window in the GUI.
+    TileRenderer tile_renderer("serif", TileMemoryBudget, thread_count);
+    tile_renderer.set_display_list(display_list, display_list_index);
+
+    start_time = std::chrono::steady_clock::now();
+
+    auto* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, image_height);
+    KoriDefer { cairo_surface_destroy(surface); };
+
+    auto* cairo_ctx = cairo_create(surface);
+    KoriDefer { cairo_destroy(cairo_ctx); };
+
+    paint_page(tile_renderer, cairo_ctx, width, image_height);
+    cairo_surface_flush(surface);
+
+    const auto paint_ms = milliseconds_since(start_time);
+
+    size_t resource_bytes = 0;
+    size_t style_rules = 0;
+
+    for (const auto& resource : resources)
+    {
+        resource_bytes += resource.data.length();
+    }
+
+    for (const auto& style_sheet : style_sheets)
+    {
+        style_rules += style_sheet.rules().size();
+    }
+
+    std::println("Rendered {} ({} bytes, {} display commands) at {}x{}", input_path.string(), html.length(), display_list.commands().size(), width, image_height);
+    std::println("Loaded {} resources ({} bytes), {} style sheets with {} rules", resources.size(), resource_bytes, style_sheets.size(), style_rules);
+    std::println("  parse:  {:8.3f} ms", parse_ms);
+    std::println("  style:  {:8.3f} ms", style_ms);
+    std::println("  layout: {:8.3f} ms", layout_ms);
+    std::println("  paint:  {:8.3f} ms", paint_ms);
+    std::println("  total:  {:8.3f} ms", parse_ms + style_ms + layout_ms + paint_ms);
+
+    if (output_path.empty())
+    {
+        return 0;
+    }
+
+    const bool written = output_path.extension() == ".png"
+        ? cairo_surface_write_to_png(surface, output_path.c_str()) == CAIRO_STATUS_SUCCESS
+        : write_ppm(surface, output_path);
+
+    if (!written)
+    {
+        std::println("Failed writing {}", output_path.string());
+        return 1;
+    }
+
+    return 0;
+}
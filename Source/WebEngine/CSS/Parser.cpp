@@ -0,0 +1,552 @@
+#include "Parser.hpp"
+
+#include "WebEngine/Core/Core.hpp"
+
+namespace Hanami::CSS {
+
+    // NOTE: Blocks nest by recursion, deeper ones are skipped so that a style sheet can't run the parser out of stack.
+    static constexpr size_t MaxNestingDepth = 64;
+
+    static auto block_end(TokenType type) noexcept -> std::optional<TokenType>
+    {
+        switch (type)
+        {
+            case TokenType::OpenCurly: return TokenType::CloseCurly;
+            case TokenType::OpenSquare: return TokenType::CloseSquare;
+            case TokenType::OpenParen: return TokenType::CloseParen;
+            case TokenType::Function: return TokenType::CloseParen;
+            default: return std::nullopt;
+        }
+    }
+
+    static auto at_rule_type(std::string_view name) noexcept -> RuleType
+    {
+        static constexpr std::array<std::pair<std::string_view, RuleType>, 9> types = {{
+            { "media", RuleType::Media },
+            { "supports", RuleType::Supports },
+            { "layer", RuleType::Layer },
+            { "container", RuleType::Container },
+            { "keyframes", RuleType::Keyframes },
+            { "font-face", RuleType::FontFace },
+            { "page", RuleType::Page },
+            { "import", RuleType::Import },
+            { "namespace", RuleType::Namespace },
+        }};
+
+        const auto it = std::ranges::find_if(types, [&](const auto& type) { return equals_case_insensitive(type.first, name); });
+        return it != types.end() ? it->second : RuleType::Unknown;
+    }
+
+    // Conditional group rules and @layer, which can be nested in style rules.
+    static auto is_group_rule(RuleType type) noexcept -> bool
+    {
+        return type == RuleType::Media || type == RuleType::Supports || type == RuleType::Layer || type == RuleType::Container;
+    }
+
+    auto Parser::parse_style_sheet(std::string source) -> StyleSheet
+    {
+        StyleSheet sheet;
+        sheet.m_text = std::move(source);
+
+        Tokenizer::preprocess(sheet.m_text);
+        sheet.m_tokens = Tokenizer::tokenize(sheet.m_text);
+
+        Parser parser(sheet, sheet.m_rules, sheet.m_declarations);
+        parser.consume_style_sheet_contents();
+
+        return sheet;
+    }
+
+    auto Parser::parse_style_attribute(std::string source) -> DeclarationBlock
+    {
+        DeclarationBlock block;
+        block.m_text = std::move(source);
+
+        Tokenizer::preprocess(block.m_text);
+        block.m_tokens = Tokenizer::tokenize(block.m_text);
+
+        std::vector<Rule> nested_rules;
+        std::vector<Declaration> nested_declarations;
+
+        // NOTE: The contents are parsed as if they were in the block of a style rule, apart from not ending at a "}".
+        Parser parser(block, nested_rules, nested_declarations);
+        parser.m_depth = 1;
+        parser.m_in_style_rule = true;
+        parser.m_in_style_attribute = true;
+        parser.consume_block_contents(RuleType::Style);
+
+        block.m_declarations = std::move(parser.m_pending_declarations);
+        return block;
+    }
+
+    Parser::Parser(const StyleSource& source, std::vector<Rule>& rules, std::vector<Declaration>& declarations) noexcept
+        : m_tokens(source.tokens())
+        , m_source(source)
+        , m_rules(rules)
+        , m_declarations(declarations)
+    {
+    }
+
+    void Parser::skip_whitespace() noexcept
+    {
+        while (peek().type == TokenType::Whitespace)
+        {
+            ++m_index;
+        }
+    }
+
+    auto Parser::trimmed(TokenRange range) const noexcept -> TokenRange
+    {
+        while (range.begin < range.end && m_tokens[range.begin].type == TokenType::Whitespace)
+        {
+            ++range.begin;
+        }
+
+        while (range.end > range.begin && m_tokens[range.end - 1].type == TokenType::Whitespace)
+        {
+            --range.end;
+        }
+
+        return range;
+    }
+
+    void Parser::consume_component_value()
+    {
+        // NOTE: The end-of-file token is never consumed, everything ends before it.
+        if (peek().type == TokenType::EndOfFile)
+        {
+            return;
+        }
+
+        // Any token that doesn't start a block or function is a component value by itself.
+        if (!block_end(peek().type))
+        {
+            ++m_index;
+            return;
+        }
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-simple-block
+        // https://drafts.csswg.org/css-syntax-3/#consume-function
+        // NOTE: Nested blocks are tracked with a stack instead of recursion, only their extent is needed here. A token
+        //       that ends some other kind of block than the innermost one is just a token in it.
+        m_block_ends.clear();
+
+        do
+        {
+            const auto type = peek().type;
+
+            if (type == TokenType::EndOfFile)
+            {
+                // This is a parse error.
+                return;
+            }
+
+            ++m_index;
+
+            if (auto end = block_end(type))
+            {
+                m_block_ends.push_back(*end);
+            }
+            else if (type == m_block_ends.back())
+            {
+                m_block_ends.pop_back();
+            }
+        } while (!m_block_ends.empty());
+    }
+
+    void Parser::consume_style_sheet_contents()
+    {
+        // Process input:
+        while (true)
+        {
+            switch (peek().type)
+            {
+                // <whitespace-token>
+                //     Discard a token from input.
+                case TokenType::Whitespace:
+                {
+                    ++m_index;
+                    break;
+                }
+                // <EOF-token>
+                //     Return rules.
+                case TokenType::EndOfFile:
+                {
+                    return;
+                }
+                // <CDO-token>
+                // <CDC-token>
+                //     Discard a token from input.
+                case TokenType::CDO:
+                case TokenType::CDC:
+                {
+                    ++m_index;
+                    break;
+                }
+                // <at-keyword-token>
+                //     Consume an at-rule from input. If anything is returned, append it to rules.
+                case TokenType::AtKeyword:
+                {
+                    consume_at_rule();
+                    break;
+                }
+                // anything else
+                //     Consume a qualified rule from input. If a rule is returned, append it to rules.
+                default:
+                {
+                    consume_qualified_rule(RuleType::Style);
+                    break;
+                }
+            }
+        }
+    }
+
+    void Parser::consume_at_rule()
+    {
+        const bool nested = m_depth > 0;
+
+        // Assert: The next token is an <at-keyword-token>.
+        // Consume a token from input, and let rule be a new at-rule with its name set to the returned token's value, its
+        // prelude initially set to an empty list, and no declarations or child rules.
+        auto rule = Rule{
+            .type = at_rule_type(m_source.value(peek())),
+            .name = static_cast<uint32_t>(m_index),
+        };
+
+        ++m_index;
+        const auto prelude_begin = static_cast<uint32_t>(m_index);
+
+        // Process input:
+        while (true)
+        {
+            rule.prelude = trimmed({ .begin = prelude_begin, .end = static_cast<uint32_t>(m_index) });
+
+            switch (peek().type)
+            {
+                // <semicolon-token>
+                //     Discard a token from input. If rule is valid in the current context, return it; otherwise return nothing.
+                case TokenType::Semicolon:
+                {
+                    ++m_index;
+                    m_rules.push_back(rule);
+                    return;
+                }
+                // <EOF-token>
+                //     This is a parse error. If rule is valid in the current context, return it; otherwise return nothing.
+                case TokenType::EndOfFile:
+                {
+                    m_rules.push_back(rule);
+                    return;
+                }
+                // <}-token>
+                case TokenType::CloseCurly:
+                {
+                    // If nested is true:
+                    //     If rule is valid in the current context, return it. Otherwise, return nothing.
+                    if (nested)
+                    {
+                        m_rules.push_back(rule);
+                        return;
+                    }
+
+                    // Otherwise, consume a token and append the result to rule's prelude.
+                    ++m_index;
+                    break;
+                }
+                // <{-token>
+                //     Consume a block from input, and assign the result to rule's child rules.
+                //     If rule is valid in the current context, return it. Otherwise, return nothing.
+                case TokenType::OpenCurly:
+                {
+                    consume_block(rule);
+                    return;
+                }
+                // anything else
+                //     Consume a component value from input and append the returned value to rule's prelude.
+                default:
+                {
+                    consume_component_value();
+                    break;
+                }
+            }
+        }
+    }
+
+    void Parser::consume_qualified_rule(RuleType type)
+    {
+        const bool nested = m_depth > 0;
+        const auto prelude_begin = static_cast<uint32_t>(m_index);
+
+        // Process input:
+        while (true)
+        {
+            switch (peek().type)
+            {
+                // <EOF-token>
+                //     This is a parse error. Return nothing.
+                case TokenType::EndOfFile:
+                {
+                    return;
+                }
+                // stop token (if passed)
+                //     This is a parse error. Return nothing.
+                // NOTE: A nested rule stops at a semicolon, which is left for the block contents to discard.
+                case TokenType::Semicolon:
+                {
+                    if (nested)
+                    {
+                        return;
+                    }
+
+                    ++m_index;
+                    break;
+                }
+                // <}-token>
+                //     This is a parse error. If nested is true, return nothing. Otherwise, consume a token and append
+                //     the result to rule's prelude.
+                case TokenType::CloseCurly:
+                {
+                    if (nested)
+                    {
+                        return;
+                    }
+
+                    ++m_index;
+                    break;
+                }
+                // <{-token>
+                case TokenType::OpenCurly:
+                {
+                    // Consume a block from input, and assign the results to rule's lists of declarations and child rules.
+                    // If rule is valid in the current context, return it; otherwise return nothing.
+                    // NOTE: The selectors aren't parsed yet, so any prelude is valid.
+                    consume_block({
+                        .type = type,
+                        .prelude = trimmed({ .begin = prelude_begin, .end = static_cast<uint32_t>(m_index) }),
+                    });
+                    return;
+                }
+                // anything else
+                //     Consume a component value from input and append the result to rule's prelude.
+                default:
+                {
+                    consume_component_value();
+                    break;
+                }
+            }
+        }
+    }
+
+    void Parser::consume_block(Rule rule)
+    {
+        const auto index = m_rules.size();
+        const auto first_pending = m_pending_declarations.size();
+
+        m_rules.push_back(rule);
+
+        // NOTE: The block of an unknown at-rule could be anything, and is skipped like one that is nested too deeply.
+        if (rule.type == RuleType::Unknown || m_depth >= MaxNestingDepth)
+        {
+            consume_component_value();
+        }
+        else
+        {
+            // Assert: The next token is a <{-token>.
+            // Discard a token from input.
+            ++m_index;
+            ++m_depth;
+
+            const bool was_in_style_rule = m_in_style_rule;
+            m_in_style_rule = m_in_style_rule || rule.type == RuleType::Style;
+
+            // Consume a block's contents from input and let rules be the result.
+            consume_block_contents(rule.type);
+
+            m_in_style_rule = was_in_style_rule;
+            --m_depth;
+        }
+
+        auto& result = m_rules[index];
+        result.first_declaration = static_cast<uint32_t>(m_declarations.size());
+        result.declaration_count = static_cast<uint32_t>(m_pending_declarations.size() - first_pending);
+        result.descendant_count = static_cast<uint32_t>(m_rules.size() - index - 1);
+
+        m_declarations.insert(m_declarations.end(), m_pending_declarations.begin() + first_pending, m_pending_declarations.end());
+        m_pending_declarations.resize(first_pending);
+    }
+
+    void Parser::consume_block_contents(RuleType type)
+    {
+        // NOTE: Which of declarations and nested rules a block may have depends on its rule, the others are parsed all
+        //       the same (that's where the block ends) but dropped.
+        const bool declarations_allowed =
+            type == RuleType::Style || type == RuleType::Keyframe || type == RuleType::FontFace || type == RuleType::Page ||
+            (is_group_rule(type) && m_in_style_rule);
+
+        const bool at_rules_allowed = type == RuleType::Style || is_group_rule(type);
+        const bool qualified_rules_allowed = at_rules_allowed || type == RuleType::Keyframes;
+
+        auto drop_rules_after = [&](size_t rule_count, size_t declaration_count)
+        {
+            m_rules.resize(rule_count);
+            m_declarations.resize(declaration_count);
+        };
+
+        // Process input:
+        while (true)
+        {
+            const auto rule_count = m_rules.size();
+            const auto declaration_count = m_declarations.size();
+
+            switch (peek().type)
+            {
+                // <whitespace-token>
+                // <semicolon-token>
+                //     Discard a token from input.
+                case TokenType::Whitespace:
+                case TokenType::Semicolon:
+                {
+                    ++m_index;
+                    break;
+                }
+                // <EOF-token>
+                //     Return rules.
+                case TokenType::EndOfFile:
+                {
+                    return;
+                }
+                // <}-token>
+                //     Discard a token from input. Return rules.
+                case TokenType::CloseCurly:
+                {
+                    ++m_index;
+
+                    // NOTE: The contents of a style attribute aren't in a block, there this is a parse error and the
+                    //       token is skipped.
+                    if (m_in_style_attribute && m_depth == 1)
+                    {
+                        break;
+                    }
+
+                    return;
+                }
+                // <at-keyword-token>
+                //     Consume an at-rule from input, with nested set to true. If a rule was returned, append it to rules.
+                case TokenType::AtKeyword:
+                {
+                    consume_at_rule();
+
+                    if (!at_rules_allowed)
+                    {
+                        drop_rules_after(rule_count, declaration_count);
+                    }
+
+                    break;
+                }
+                // anything else
+                default:
+                {
+                    // Mark input.
+                    const auto mark = m_index;
+
+                    // Consume a declaration from input, with nested set to true. If a declaration was returned, append it
+                    // to decls, and discard a mark from input.
+                    if (declarations_allowed && consume_declaration())
+                    {
+                        break;
+                    }
+
+                    // Otherwise, restore a mark from input, then consume a qualified rule from input, with nested set to
+                    // true, and nested block set to true. If a rule was returned, append it to rules.
+                    m_index = mark;
+                    consume_qualified_rule(type == RuleType::Keyframes ? RuleType::Keyframe : RuleType::Style);
+
+                    if (!qualified_rules_allowed)
+                    {
+                        drop_rules_after(rule_count, declaration_count);
+                    }
+
+                    break;
+                }
+            }
+        }
+    }
+
+    auto Parser::consume_declaration() -> bool
+    {
+        // If the next token is an <ident-token>, consume a token from input and set decl's name to the token's value.
+        // Otherwise, consume the remnants of a bad declaration from input, with nested, and return nothing.
+        // NOTE: The caller goes back to where the declaration started in that case, so nothing is consumed here.
+        if (peek().type != TokenType::Ident)
+        {
+            return false;
+        }
+
+        const auto name = static_cast<uint32_t>(m_index++);
+
+        // Discard whitespace from input.
+        skip_whitespace();
+
+        // If the next token is a <colon-token>, discard a token from input.
+        // Otherwise, consume the remnants of a bad declaration from input, with nested, and return nothing.
+        if (peek().type != TokenType::Colon)
+        {
+            return false;
+        }
+
+        ++m_index;
+
+        // Discard whitespace from input.
+        skip_whitespace();
+
+        // Consume a list of component values from input, with nested, and with <semicolon-token> as the stop token, and
+        // set decl's value to the result.
+        const auto value_begin = static_cast<uint32_t>(m_index);
+        bool has_block = false;
+
+        while (peek().type != TokenType::Semicolon && peek().type != TokenType::CloseCurly && peek().type != TokenType::EndOfFile)
+        {
+            has_block = has_block || peek().type == TokenType::OpenCurly;
+            consume_component_value();
+        }
+
+        auto declaration = Declaration{
+            .property = property_id(m_source.value(m_tokens[name])),
+            .name = name,
+            .value = trimmed({ .begin = value_begin, .end = static_cast<uint32_t>(m_index) }),
+        };
+
+        // If decl's name is a custom property name, then:
+        //     If decl's value contains a top-level simple block with an associated token of <{-token>, and also contains
+        //     any other non-<whitespace-token> value, return nothing.
+        // Otherwise, if decl's value contains a top-level simple block with an associated token of <{-token>, return
+        // nothing.
+        // NOTE: That makes it a nested rule instead, e.g. "a:hover { ... }".
+        if (has_block && (declaration.property != PropertyID::Custom || m_tokens[declaration.value.begin].type != TokenType::OpenCurly))
+        {
+            return false;
+        }
+
+        // If the last two non-<whitespace-token>s in decl's value are a <delim-token> with the value "!" followed by an
+        // <ident-token> with a value that is an ASCII case-insensitive match for "important", remove them from decl's
+        // value and set decl's important flag.
+        auto& value = declaration.value;
+
+        if (!value.empty() && m_tokens[value.end - 1].type == TokenType::Ident && equals_case_insensitive(m_source.value(m_tokens[value.end - 1]), "important"))
+        {
+            const auto before = trimmed({ .begin = value.begin, .end = value.end - 1 });
+
+            if (!before.empty() && m_tokens[before.end - 1].type == TokenType::Delim && m_source.value(m_tokens[before.end - 1]) == "!")
+            {
+                declaration.important = true;
+
+                // While the last item in decl's value is a <whitespace-token>, remove that token.
+                value = trimmed({ .begin = value.begin, .end = before.end - 1 });
+            }
+        }
+
+        m_pending_declarations.push_back(declaration);
+        return true;
+    }
+
+}
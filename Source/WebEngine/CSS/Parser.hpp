@@ -0,0 +1,80 @@
+#pragma once
+
+#include "StyleSheet.hpp"
+
+namespace Hanami::CSS {
+
+    // Builds the rules and declarations of a style sheet or style attribute from its tokens, which are all produced up
+    // front into a flat list that the parser walks by index.
+    // https://drafts.csswg.org/css-syntax-3/#parsing
+    class Parser
+    {
+    public:
+        // https://drafts.csswg.org/css-syntax-3/#parse-a-css-stylesheet
+        [[nodiscard]]
+        static auto parse_style_sheet(std::string source) -> StyleSheet;
+
+        // The value of a style attribute is the contents of a block, without the braces. Nested rules in it are dropped.
+        // https://drafts.csswg.org/css-style-attr/#interpret
+        [[nodiscard]]
+        static auto parse_style_attribute(std::string source) -> DeclarationBlock;
+
+    private:
+        Parser(const StyleSource& source, std::vector<Rule>& rules, std::vector<Declaration>& declarations) noexcept;
+
+        [[nodiscard]]
+        auto peek() const noexcept -> const Token& { return m_tokens[m_index]; }
+
+        void skip_whitespace() noexcept;
+
+        // Shrinks a range to leave out the whitespace at its ends.
+        [[nodiscard]]
+        auto trimmed(TokenRange range) const noexcept -> TokenRange;
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-component-value
+        void consume_component_value();
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-stylesheet-contents
+        void consume_style_sheet_contents();
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-at-rule
+        void consume_at_rule();
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-qualified-rule
+        void consume_qualified_rule(RuleType type);
+
+        // Adds rule, followed by the rules nested in its block (the next token), and its declarations.
+        // https://drafts.csswg.org/css-syntax-3/#consume-block
+        void consume_block(Rule rule);
+
+        // Adds the declarations of the block of a rule of the given type to m_pending_declarations, and its nested rules
+        // to m_rules.
+        // https://drafts.csswg.org/css-syntax-3/#consume-block-contents
+        void consume_block_contents(RuleType type);
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-declaration
+        [[nodiscard]]
+        auto consume_declaration() -> bool;
+
+        std::span<const Token> m_tokens;
+        const StyleSource& m_source;
+        size_t m_index = 0;
+
+        std::vector<Rule>& m_rules;
+        std::vector<Declaration>& m_declarations;
+
+        // The declarations of the blocks being parsed. Each block adds its declarations on top of those of the blocks
+        // it is nested in, and moves them to m_declarations when it ends, so the declarations of a rule end up next
+        // to each other even if it has rules nested between them.
+        std::vector<Declaration> m_pending_declarations;
+
+        // How many blocks of rules the parser is in, and whether one of them is a style rule.
+        size_t m_depth = 0;
+        bool m_in_style_rule = false;
+        bool m_in_style_attribute = false;
+
+        // The ends of the blocks consume_component_value() is in.
+        std::vector<TokenType> m_block_ends;
+    };
+
+}
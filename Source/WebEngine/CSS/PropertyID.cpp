@@ -0,0 +1,146 @@
+#include "PropertyID.hpp"
+
+#include <array>
+#include <algorithm>
+
+using namespace std::literals;
+
+namespace Hanami::CSS {
+
+    // Indexed by PropertyID.
+    static constexpr std::array property_names = {
+        "align-content"sv,
+        "align-items"sv,
+        "align-self"sv,
+        "background"sv,
+        "background-color"sv,
+        "background-image"sv,
+        "background-position"sv,
+        "background-repeat"sv,
+        "border"sv,
+        "border-bottom"sv,
+        "border-bottom-color"sv,
+        "border-bottom-style"sv,
+        "border-bottom-width"sv,
+        "border-collapse"sv,
+        "border-color"sv,
+        "border-left"sv,
+        "border-left-color"sv,
+        "border-left-style"sv,
+        "border-left-width"sv,
+        "border-radius"sv,
+        "border-right"sv,
+        "border-right-color"sv,
+        "border-right-style"sv,
+        "border-right-width"sv,
+        "border-spacing"sv,
+        "border-style"sv,
+        "border-top"sv,
+        "border-top-color"sv,
+        "border-top-style"sv,
+        "border-top-width"sv,
+        "border-width"sv,
+        "bottom"sv,
+        "box-sizing"sv,
+        "clear"sv,
+        "color"sv,
+        "content"sv,
+        "cursor"sv,
+        "display"sv,
+        "flex"sv,
+        "flex-basis"sv,
+        "flex-direction"sv,
+        "flex-grow"sv,
+        "flex-shrink"sv,
+        "flex-wrap"sv,
+        "float"sv,
+        "font"sv,
+        "font-family"sv,
+        "font-size"sv,
+        "font-style"sv,
+        "font-weight"sv,
+        "gap"sv,
+        "grid-template-columns"sv,
+        "grid-template-rows"sv,
+        "height"sv,
+        "justify-content"sv,
+        "left"sv,
+        "letter-spacing"sv,
+        "line-height"sv,
+        "list-style"sv,
+        "list-style-type"sv,
+        "margin"sv,
+        "margin-bottom"sv,
+        "margin-left"sv,
+        "margin-right"sv,
+        "margin-top"sv,
+        "max-height"sv,
+        "max-width"sv,
+        "min-height"sv,
+        "min-width"sv,
+        "opacity"sv,
+        "outline"sv,
+        "overflow"sv,
+        "overflow-x"sv,
+        "overflow-y"sv,
+        "padding"sv,
+        "padding-bottom"sv,
+        "padding-left"sv,
+        "padding-right"sv,
+        "padding-top"sv,
+        "position"sv,
+        "right"sv,
+        "text-align"sv,
+        "text-decoration"sv,
+        "text-indent"sv,
+        "text-transform"sv,
+        "top"sv,
+        "transform"sv,
+        "transition"sv,
+        "vertical-align"sv,
+        "visibility"sv,
+        "white-space"sv,
+        "width"sv,
+        "word-break"sv,
+        "z-index"sv,
+    };
+
+    static_assert(property_names.size() == static_cast<size_t>(PropertyID::Custom));
+    static_assert(std::ranges::is_sorted(property_names));
+
+    // Longer than any of the names above.
+    static constexpr size_t MaxPropertyNameLength = 32;
+
+    auto property_id(std::string_view name) noexcept -> PropertyID
+    {
+        if (name.starts_with("--"))
+        {
+            return PropertyID::Custom;
+        }
+
+        if (name.length() > MaxPropertyNameLength)
+        {
+            return PropertyID::Unknown;
+        }
+
+        std::array<char, MaxPropertyNameLength> buffer;
+        std::ranges::transform(name, buffer.begin(), [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c + 0x20) : c; });
+
+        const auto lowercase = std::string_view{ buffer.data(), name.length() };
+        const auto it = std::ranges::lower_bound(property_names, lowercase);
+
+        if (it == property_names.end() || *it != lowercase)
+        {
+            return PropertyID::Unknown;
+        }
+
+        return static_cast<PropertyID>(it - property_names.begin());
+    }
+
+    auto property_name(PropertyID id) noexcept -> std::string_view
+    {
+        const auto index = static_cast<size_t>(id);
+        return index < property_names.size() ? property_names[index] : std::string_view{};
+    }
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Hanami::CSS {
+
+    // The properties the engine knows by name, in the order of their names, so property names are interned as a
+    // single integer at parse time instead of being compared as strings by whatever looks them up later.
+    // https://drafts.csswg.org/indexes/#properties
+    enum class PropertyID : uint16_t
+    {
+        AlignContent,
+        AlignItems,
+        AlignSelf,
+        Background,
+        BackgroundColor,
+        BackgroundImage,
+        BackgroundPosition,
+        BackgroundRepeat,
+        Border,
+        BorderBottom,
+        BorderBottomColor,
+        BorderBottomStyle,
+        BorderBottomWidth,
+        BorderCollapse,
+        BorderColor,
+        BorderLeft,
+        BorderLeftColor,
+        BorderLeftStyle,
+        BorderLeftWidth,
+        BorderRadius,
+        BorderRight,
+        BorderRightColor,
+        BorderRightStyle,
+        BorderRightWidth,
+        BorderSpacing,
+        BorderStyle,
+        BorderTop,
+        BorderTopColor,
+        BorderTopStyle,
+        BorderTopWidth,
+        BorderWidth,
+        Bottom,
+        BoxSizing,
+        Clear,
+        Color,
+        Content,
+        Cursor,
+        Display,
+        Flex,
+        FlexBasis,
+        FlexDirection,
+        FlexGrow,
+        FlexShrink,
+        FlexWrap,
+        Float,
+        Font,
+        FontFamily,
+        FontSize,
+        FontStyle,
+        FontWeight,
+        Gap,
+        GridTemplateColumns,
+        GridTemplateRows,
+        Height,
+        JustifyContent,
+        Left,
+        LetterSpacing,
+        LineHeight,
+        ListStyle,
+        ListStyleType,
+        Margin,
+        MarginBottom,
+        MarginLeft,
+        MarginRight,
+        MarginTop,
+        MaxHeight,
+        MaxWidth,
+        MinHeight,
+        MinWidth,
+        Opacity,
+        Outline,
+        Overflow,
+        OverflowX,
+        OverflowY,
+        Padding,
+        PaddingBottom,
+        PaddingLeft,
+        PaddingRight,
+        PaddingTop,
+        Position,
+        Right,
+        TextAlign,
+        TextDecoration,
+        TextIndent,
+        TextTransform,
+        Top,
+        Transform,
+        Transition,
+        VerticalAlign,
+        Visibility,
+        WhiteSpace,
+        Width,
+        WordBreak,
+        ZIndex,
+
+        // A custom property (--*), whose name is case-sensitive and kept by the declaration.
+        // https://drafts.csswg.org/css-variables/#custom-property
+        Custom,
+
+        // Any other name, which is kept by the declaration as well.
+        Unknown,
+    };
+
+    // Looks up the property for a name, ignoring ASCII case for all but custom properties.
+    [[nodiscard]]
+    auto property_id(std::string_view name) noexcept -> PropertyID;
+
+    // The name of a known property, e.g. "background-color", or an empty string for Custom and Unknown.
+    [[nodiscard]]
+    auto property_name(PropertyID id) noexcept -> std::string_view;
+
+}
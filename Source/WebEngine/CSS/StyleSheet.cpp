@@ -0,0 +1,34 @@
+#include "StyleSheet.hpp"
+
+namespace Hanami::CSS {
+
+    auto StyleSource::source_text(TokenRange range) const noexcept -> std::string_view
+    {
+        if (range.empty())
+        {
+            return {};
+        }
+
+        // NOTE: A range never includes the end-of-file token, so there always is a token after it.
+        const auto begin = m_tokens[range.begin].offset;
+        const auto end = m_tokens[range.end].offset;
+
+        return std::string_view{ m_text }.substr(begin, end - begin);
+    }
+
+    auto DeclarationBlock::find(PropertyID property) const noexcept -> const Declaration*
+    {
+        const Declaration* result = nullptr;
+
+        for (const auto& declaration : m_declarations)
+        {
+            if (declaration.property == property && (declaration.important || !result || !result->important))
+            {
+                result = &declaration;
+            }
+        }
+
+        return result;
+    }
+
+}
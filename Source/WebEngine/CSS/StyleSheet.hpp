@@ -0,0 +1,161 @@
+#pragma once
+
+#include <span>
+
+#include "Tokenizer.hpp"
+#include "PropertyID.hpp"
+
+namespace Hanami::CSS {
+
+    // A range of the tokens of a style sheet or declaration block, nested blocks and functions included.
+    struct TokenRange
+    {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+
+        [[nodiscard]]
+        auto empty() const noexcept -> bool { return begin == end; }
+    };
+
+    // https://drafts.csswg.org/css-syntax-3/#declaration
+    struct Declaration
+    {
+        PropertyID property = PropertyID::Unknown;
+        bool important = false;
+
+        // The token with the name, which is only needed for custom and unknown properties.
+        uint32_t name = 0;
+
+        // The value, without the whitespace around it and without !important.
+        TokenRange value{};
+    };
+
+    // The text and tokens that declarations and rules point into.
+    class StyleSource
+    {
+    public:
+        [[nodiscard]]
+        auto tokens() const noexcept -> std::span<const Token> { return m_tokens; }
+
+        [[nodiscard]]
+        auto tokens(TokenRange range) const noexcept -> std::span<const Token>
+        {
+            return tokens().subspan(range.begin, range.end - range.begin);
+        }
+
+        [[nodiscard]]
+        auto value(const Token& token) const noexcept -> std::string_view
+        {
+            return std::string_view{ m_text }.substr(token.value.offset, token.value.length);
+        }
+
+        // The source text of a range of tokens, e.g. the selector of a style rule, comments and escapes included.
+        [[nodiscard]]
+        auto source_text(TokenRange range) const noexcept -> std::string_view;
+
+        [[nodiscard]]
+        auto property_name(const Declaration& declaration) const noexcept -> std::string_view
+        {
+            const auto name = CSS::property_name(declaration.property);
+            return name.empty() ? value(m_tokens[declaration.name]) : name;
+        }
+
+    protected:
+        friend class Parser;
+
+        // The preprocessed source, followed by the values of tokens with escapes in them (see Tokenizer).
+        std::string m_text;
+        std::vector<Token> m_tokens;
+    };
+
+    // The declarations of a style attribute.
+    // https://drafts.csswg.org/cssom/#css-declaration-blocks
+    class DeclarationBlock : public StyleSource
+    {
+    public:
+        [[nodiscard]]
+        auto declarations() const noexcept -> std::span<const Declaration> { return m_declarations; }
+
+        // The declaration of a known property that applies, i.e. its last important one or else its last one.
+        [[nodiscard]]
+        auto find(PropertyID property) const noexcept -> const Declaration*;
+
+    private:
+        friend class Parser;
+
+        std::vector<Declaration> m_declarations;
+    };
+
+    enum class RuleType : uint8_t
+    {
+        // https://drafts.csswg.org/css-syntax-3/#style-rules
+        Style,
+
+        // A rule in the block of @keyframes, e.g. "from { ... }".
+        Keyframe,
+
+        // At-rules with a block of rules.
+        Media,
+        Supports,
+        Layer,
+        Container,
+        Keyframes,
+
+        // At-rules with a block of declarations.
+        FontFace,
+        Page,
+
+        // At-rules without a block.
+        Import,
+        Namespace,
+
+        // Any other at-rule, whose block is skipped.
+        Unknown,
+    };
+
+    // NOTE: The rules of a style sheet are kept in one list in tree order (every rule is followed by the ones nested
+    //       in it), and point into its declaration and token lists, so that parsing a style sheet fills a handful of
+    //       vectors instead of allocating a tree of rules.
+    struct Rule
+    {
+        RuleType type = RuleType::Unknown;
+
+        // The at-keyword token of an at-rule.
+        uint32_t name = 0;
+
+        // The selector list of a style rule, or what comes between the name of an at-rule and its block.
+        TokenRange prelude{};
+
+        // The rule's own declarations, in the declaration list of the style sheet.
+        uint32_t first_declaration = 0;
+        uint32_t declaration_count = 0;
+
+        // How many rules are nested in this one, directly or not. They are the ones following it.
+        uint32_t descendant_count = 0;
+    };
+
+    // https://drafts.csswg.org/cssom/#css-style-sheets
+    class StyleSheet : public StyleSource
+    {
+    public:
+        [[nodiscard]]
+        auto rules() const noexcept -> std::span<const Rule> { return m_rules; }
+
+        [[nodiscard]]
+        auto declarations(const Rule& rule) const noexcept -> std::span<const Declaration>
+        {
+            return std::span{ m_declarations }.subspan(rule.first_declaration, rule.declaration_count);
+        }
+
+        // The index of the rule after the one at index and the rules nested in it.
+        [[nodiscard]]
+        auto next_sibling(size_t index) const noexcept -> size_t { return index + 1 + m_rules[index].descendant_count; }
+
+    private:
+        friend class Parser;
+
+        std::vector<Rule> m_rules;
+        std::vector<Declaration> m_declarations;
+    };
+
+}
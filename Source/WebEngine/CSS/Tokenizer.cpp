@@ -0,0 +1,957 @@
+#include "Tokenizer.hpp"
+
+#include <bit>
+#include <charconv>
+
+#include <Kori/Utf8String.hpp>
+
+#include "WebEngine/Core/Core.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define HANAMI_HAS_SSE2 1
+#endif
+
+namespace Hanami::CSS {
+
+    // https://drafts.csswg.org/css-syntax-3/#whitespace
+    // NOTE: There are no CRs or FFs left after preprocessing.
+    static auto is_whitespace(char c) noexcept -> bool
+    {
+        return c == ' ' || c == '\n' || c == '\t';
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#ident-start-code-point
+    // NOTE: Every byte of a multi-byte UTF-8 sequence is a non-ASCII byte, so looking at bytes is enough.
+    static auto is_ident_start_code_point(char c) noexcept -> bool
+    {
+        return is_ascii_alpha(c) || c == '_' || static_cast<uint8_t>(c) >= 0x80;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#ident-code-point
+    static auto is_ident_code_point(char c) noexcept -> bool
+    {
+        return is_ident_start_code_point(c) || is_ascii_digit(c) || c == '-';
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#non-printable-code-point
+    static auto is_non_printable_code_point(char c) noexcept -> bool
+    {
+        return (c >= '\0' && c <= '\x08') || c == '\x0B' || (c >= '\x0E' && c <= '\x1F') || c == '\x7F';
+    }
+
+    static auto hex_digit_value(char c) noexcept -> std::optional<uint32_t>
+    {
+        if (is_ascii_digit(c))
+        {
+            return c - '0';
+        }
+
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+
+        return std::nullopt;
+    }
+
+    static auto needs_preprocessing(std::string_view input) noexcept -> bool
+    {
+        size_t i = 0;
+
+#if defined(HANAMI_HAS_SSE2)
+        const auto cr = _mm_set1_epi8('\r');
+        const auto ff = _mm_set1_epi8('\f');
+
+        for (; i + 16 <= input.length(); i += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+            const auto found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, cr), _mm_cmpeq_epi8(bytes, ff)), _mm_cmpeq_epi8(bytes, _mm_setzero_si128()));
+
+            if (_mm_movemask_epi8(found) != 0)
+            {
+                return true;
+            }
+        }
+#endif
+
+        for (; i < input.length(); ++i)
+        {
+            if (input[i] == '\r' || input[i] == '\f' || input[i] == '\0')
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // The end of the run of whitespace starting at position.
+    static auto skip_whitespace(std::string_view input, size_t position) noexcept -> size_t
+    {
+#if defined(HANAMI_HAS_SSE2)
+        const auto space = _mm_set1_epi8(' ');
+        const auto newline = _mm_set1_epi8('\n');
+        const auto tab = _mm_set1_epi8('\t');
+
+        for (; position + 16 <= input.length(); position += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position));
+            const auto found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, newline)), _mm_cmpeq_epi8(bytes, tab));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+
+            if (mask != 0xFFFF)
+            {
+                return position + static_cast<size_t>(std::countr_one(mask));
+            }
+        }
+#endif
+
+        while (position < input.length() && is_whitespace(input[position]))
+        {
+            ++position;
+        }
+
+        return position;
+    }
+
+    // The end of the run of ident code points starting at position, which an escape may continue.
+    static auto skip_ident_code_points(std::string_view input, size_t position) noexcept -> size_t
+    {
+#if defined(HANAMI_HAS_SSE2)
+        for (; position + 16 <= input.length(); position += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position));
+
+            // NOTE: The comparisons are signed, so they never match non-ASCII bytes, those are all ident code points by
+            //       themselves (see the movemask below).
+            const auto lowercase = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+            const auto letters = _mm_and_si128(_mm_cmpgt_epi8(lowercase, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lowercase, _mm_set1_epi8('z' + 1)));
+            const auto digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+            const auto others = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_')));
+
+            const auto found = _mm_or_si128(_mm_or_si128(letters, digits), others);
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found) | _mm_movemask_epi8(bytes));
+
+            if (mask != 0xFFFF)
+            {
+                return position + static_cast<size_t>(std::countr_one(mask));
+            }
+        }
+#endif
+
+        while (position < input.length() && is_ident_code_point(input[position]))
+        {
+            ++position;
+        }
+
+        return position;
+    }
+
+    // The first code point at or after position that a string token has to look at: its ending quote, an escape or a
+    // newline.
+    static auto find_string_special(std::string_view input, size_t position, char ending) noexcept -> size_t
+    {
+#if defined(HANAMI_HAS_SSE2)
+        const auto quote = _mm_set1_epi8(ending);
+        const auto backslash = _mm_set1_epi8('\\');
+        const auto newline = _mm_set1_epi8('\n');
+
+        for (; position + 16 <= input.length(); position += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + position));
+            const auto found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)), _mm_cmpeq_epi8(bytes, newline));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+
+            if (mask != 0)
+            {
+                return position + static_cast<size_t>(std::countr_zero(mask));
+            }
+        }
+#endif
+
+        while (position < input.length() && input[position] != ending && input[position] != '\\' && input[position] != '\n')
+        {
+            ++position;
+        }
+
+        return position;
+    }
+
+    void Tokenizer::preprocess(std::string& text)
+    {
+        if (!needs_preprocessing(text))
+        {
+            return;
+        }
+
+        std::string result;
+        result.reserve(text.length());
+
+        for (size_t i = 0; i < text.length(); ++i)
+        {
+            switch (text[i])
+            {
+                case '\r':
+                {
+                    result += '\n';
+
+                    if (i + 1 < text.length() && text[i + 1] == '\n')
+                    {
+                        ++i;
+                    }
+
+                    break;
+                }
+                case '\f':
+                {
+                    result += '\n';
+                    break;
+                }
+                case '\0':
+                {
+                    result += "\xEF\xBF\xBD";
+                    break;
+                }
+                default:
+                {
+                    result += text[i];
+                    break;
+                }
+            }
+        }
+
+        text = std::move(result);
+    }
+
+    Tokenizer::Tokenizer(std::string& text) noexcept
+        : m_text(text)
+        , m_input_length(text.length())
+    {
+    }
+
+    auto Tokenizer::tokenize(std::string& text) -> std::vector<Token>
+    {
+        Tokenizer tokenizer(text);
+        std::vector<Token> tokens;
+
+        // NOTE: A guess, style sheets have a token every few bytes.
+        tokens.reserve(text.length() / 4 + 1);
+
+        do
+        {
+            tokens.push_back(tokenizer.next_token());
+        } while (tokens.back().type != TokenType::EndOfFile);
+
+        return tokens;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#starts-with-a-valid-escape
+    auto Tokenizer::is_valid_escape(size_t ahead) const noexcept -> bool
+    {
+        // If the first code point is not U+005C REVERSE SOLIDUS (\), return false.
+        // Otherwise, if the second code point is a newline, return false.
+        // Otherwise, return true.
+        return peek(ahead) == '\\' && peek(ahead + 1) != '\n';
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#would-start-an-identifier
+    auto Tokenizer::would_start_ident_sequence(size_t ahead) const noexcept -> bool
+    {
+        const char first = peek(ahead);
+
+        // U+002D HYPHEN-MINUS
+        if (first == '-')
+        {
+            // If the second code point is an ident-start code point or a U+002D HYPHEN-MINUS, or the second and third
+            // code points are a valid escape, return true. Otherwise, return false.
+            const char second = peek(ahead + 1);
+            return is_ident_start_code_point(second) || second == '-' || is_valid_escape(ahead + 1);
+        }
+
+        // ident-start code point
+        if (is_ident_start_code_point(first))
+        {
+            return true;
+        }
+
+        // U+005C REVERSE SOLIDUS (\)
+        //     If the first and second code points are a valid escape, return true. Otherwise, return false.
+        return is_valid_escape(ahead);
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#starts-with-a-number
+    auto Tokenizer::would_start_number() const noexcept -> bool
+    {
+        const char first = peek();
+
+        // U+002B PLUS SIGN (+)
+        // U+002D HYPHEN-MINUS (-)
+        if (first == '+' || first == '-')
+        {
+            // If the second code point is a digit, return true.
+            // Otherwise, if the second code point is a U+002E FULL STOP (.) and the third code point is a digit, return true.
+            return is_ascii_digit(peek(1)) || (peek(1) == '.' && is_ascii_digit(peek(2)));
+        }
+
+        // U+002E FULL STOP (.)
+        if (first == '.')
+        {
+            // If the second code point is a digit, return true. Otherwise, return false.
+            return is_ascii_digit(peek(1));
+        }
+
+        return is_ascii_digit(first);
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-comment
+    void Tokenizer::consume_comments() noexcept
+    {
+        // If the next two input code point are U+002F SOLIDUS (/) followed by a U+002A ASTERISK (*), consume them and all
+        // following code points up to and including the first U+002A ASTERISK (*) followed by a U+002F SOLIDUS (/), or
+        // up to an EOF code point. Return to the start of this step.
+        while (peek() == '/' && peek(1) == '*')
+        {
+            // NOTE: find() is a memchr() for the asterisk, which is already vectorized.
+            const auto end = input().find("*/", m_position + 2);
+
+            // If the preceding paragraph ended by consuming an EOF code point, this is a parse error.
+            m_position = end == std::string_view::npos ? m_input_length : end + 2;
+        }
+    }
+
+    void Tokenizer::begin_value() noexcept
+    {
+        m_value_start = m_position;
+        m_copying_value = false;
+    }
+
+    void Tokenizer::flush_value(size_t end)
+    {
+        if (!m_copying_value)
+        {
+            m_value.clear();
+            m_copying_value = true;
+        }
+
+        m_value.append(input().substr(m_value_start, end - m_value_start));
+    }
+
+    auto Tokenizer::end_value(size_t end) -> TextRange
+    {
+        if (!m_copying_value)
+        {
+            return { .offset = static_cast<uint32_t>(m_value_start), .length = static_cast<uint32_t>(end - m_value_start) };
+        }
+
+        flush_value(end);
+
+        const auto offset = m_text.length();
+        m_text += m_value;
+
+        return { .offset = static_cast<uint32_t>(offset), .length = static_cast<uint32_t>(m_value.length()) };
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-escaped-code-point
+    void Tokenizer::consume_escaped_code_point()
+    {
+        // Consume the next input code point.
+        // EOF
+        if (m_position >= m_input_length)
+        {
+            // This is a parse error. Return U+FFFD REPLACEMENT CHARACTER (�).
+            m_value += "\xEF\xBF\xBD";
+            m_value_start = m_position;
+            return;
+        }
+
+        // hex digit
+        if (hex_digit_value(peek()))
+        {
+            // Consume as many hex digits as possible, but no more than 5. Note that this means 1-6 hex digits have been
+            // consumed in total.
+            uint32_t code_point = 0;
+
+            for (int i = 0; i < 6 && hex_digit_value(peek()); ++i)
+            {
+                code_point = code_point * 16 + *hex_digit_value(peek());
+                ++m_position;
+            }
+
+            // If the next input code point is whitespace, consume it as well.
+            if (is_whitespace(peek()))
+            {
+                ++m_position;
+            }
+
+            // If this number is zero, or is for a surrogate, or is greater than the maximum allowed code point, return
+            // U+FFFD REPLACEMENT CHARACTER (�).
+            if (code_point == 0 || is_unicode_surrogate(code_point) || code_point > 0x10FFFF)
+            {
+                code_point = 0xFFFD;
+            }
+
+            // Otherwise, return the code point with that value.
+            if (code_point < 0x80)
+            {
+                m_value += static_cast<char>(code_point);
+            }
+            else
+            {
+                auto codepoint = Kori::Codepoint::from_utf32(code_point);
+                for (uint8_t i = 0; i < codepoint.used_bytes; ++i)
+                {
+                    m_value += static_cast<char>(codepoint.bytes[i]);
+                }
+            }
+
+            m_value_start = m_position;
+            return;
+        }
+
+        // anything else
+        //     Return the current input code point.
+        const auto lead = static_cast<uint8_t>(peek());
+        const size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+        const auto sequence = input().substr(m_position, length);
+
+        m_value += sequence;
+        m_position += sequence.length();
+        m_value_start = m_position;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-name
+    auto Tokenizer::consume_ident_sequence() -> TextRange
+    {
+        begin_value();
+
+        // Repeatedly consume the next input code point from the stream:
+        while (true)
+        {
+            // ident code point
+            //     Append the code point to result.
+            m_position = skip_ident_code_points(input(), m_position);
+
+            // the stream starts with a valid escape
+            if (!is_valid_escape())
+            {
+                break;
+            }
+
+            // Consume an escaped code point. Append the returned code point to result.
+            flush_value(m_position);
+            ++m_position;
+            consume_escaped_code_point();
+        }
+
+        // anything else
+        //     Reconsume the current input code point. Return result.
+        return end_value(m_position);
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-numeric-token
+    void Tokenizer::consume_numeric_token(Token& token)
+    {
+        // Consume a number and let number be the result.
+        // https://drafts.csswg.org/css-syntax-3/#consume-number
+        const auto start = m_position;
+        bool integer = true;
+
+        // If the next input code point is U+002B PLUS SIGN (+) or U+002D HYPHEN-MINUS (-), consume it.
+        if (peek() == '+' || peek() == '-')
+        {
+            ++m_position;
+        }
+
+        // While the next input code point is a digit, consume it.
+        while (is_ascii_digit(peek()))
+        {
+            ++m_position;
+        }
+
+        // If the next 2 input code points are U+002E FULL STOP (.) followed by a digit, then consume them and all
+        // digits after them, and set type to "number".
+        if (peek() == '.' && is_ascii_digit(peek(1)))
+        {
+            integer = false;
+            m_position += 2;
+
+            while (is_ascii_digit(peek()))
+            {
+                ++m_position;
+            }
+        }
+
+        // If the next 2 or 3 input code points are U+0045 LATIN CAPITAL LETTER E (E) or U+0065 LATIN SMALL LETTER E (e),
+        // optionally followed by U+002D HYPHEN-MINUS (-) or U+002B PLUS SIGN (+), followed by a digit, then consume them
+        // and all digits after them, and set type to "number".
+        if (peek() == 'e' || peek() == 'E')
+        {
+            const size_t sign = peek(1) == '+' || peek(1) == '-';
+
+            if (is_ascii_digit(peek(1 + sign)))
+            {
+                integer = false;
+                m_position += 2 + sign;
+
+                while (is_ascii_digit(peek()))
+                {
+                    ++m_position;
+                }
+            }
+        }
+
+        // Convert repr to a number.
+        // NOTE: from_chars() follows strtod() apart from rejecting a leading plus sign, and it doesn't depend on the locale.
+        auto repr = input().substr(start, m_position - start);
+
+        if (repr.starts_with('+'))
+        {
+            repr.remove_prefix(1);
+        }
+
+        (void)std::from_chars(repr.data(), repr.data() + repr.length(), token.number);
+        token.flag = integer;
+
+        // If the next 3 input code points would start an ident sequence, then:
+        if (would_start_ident_sequence())
+        {
+            // Create a <dimension-token> with the same value and type flag as number, and a unit set initially to the
+            // empty string. Consume an ident sequence. Set the <dimension-token>'s unit to the returned value.
+            token.type = TokenType::Dimension;
+            token.value = consume_ident_sequence();
+            return;
+        }
+
+        // Otherwise, if the next input code point is U+0025 PERCENTAGE SIGN (%), consume it. Create a
+        // <percentage-token> with the same value as number, and return it.
+        if (peek() == '%')
+        {
+            ++m_position;
+            token.type = TokenType::Percentage;
+            return;
+        }
+
+        // Otherwise, create a <number-token> with the same value and type flag as number, and return it.
+        token.type = TokenType::Number;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-ident-like-token
+    void Tokenizer::consume_ident_like_token(Token& token)
+    {
+        // Consume an ident sequence, and let string be the result.
+        token.value = consume_ident_sequence();
+
+        const auto string = std::string_view{ m_text }.substr(token.value.offset, token.value.length);
+
+        // If string's value is an ASCII case-insensitive match for "url", and the next input code point is U+0028 LEFT
+        // PARENTHESIS ((), consume it.
+        if (peek() == '(' && equals_case_insensitive(string, "url"))
+        {
+            ++m_position;
+
+            // While the next two input code points are whitespace, consume the next input code point.
+            while (is_whitespace(peek()) && is_whitespace(peek(1)))
+            {
+                ++m_position;
+            }
+
+            // If the next one or two input code points are U+0022 QUOTATION MARK ("), U+0027 APOSTROPHE ('), or
+            // whitespace followed by U+0022 QUOTATION MARK (") or U+0027 APOSTROPHE ('), then create a <function-token>
+            // with its value set to string and return it.
+            const char next = is_whitespace(peek()) ? peek(1) : peek();
+
+            if (next == '"' || next == '\'')
+            {
+                token.type = TokenType::Function;
+                return;
+            }
+
+            // Otherwise, consume a url token, and return it.
+            consume_url_token(token);
+            return;
+        }
+
+        // Otherwise, if the next input code point is U+0028 LEFT PARENTHESIS ((), consume it. Create a <function-token>
+        // with its value set to string and return it.
+        if (peek() == '(')
+        {
+            ++m_position;
+            token.type = TokenType::Function;
+            return;
+        }
+
+        // Otherwise, create an <ident-token> with its value set to string and return it.
+        token.type = TokenType::Ident;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-string-token
+    void Tokenizer::consume_string_token(Token& token, char ending)
+    {
+        // Initially create a <string-token> with its value set to the empty string.
+        token.type = TokenType::String;
+        begin_value();
+
+        // Repeatedly consume the next input code point from the stream:
+        while (true)
+        {
+            // anything else
+            //     Append the current input code point to the <string-token>'s value.
+            m_position = find_string_special(input(), m_position, ending);
+
+            // EOF
+            if (m_position >= m_input_length)
+            {
+                // This is a parse error. Return the <string-token>.
+                token.value = end_value(m_position);
+                return;
+            }
+
+            const char c = input()[m_position];
+
+            // ending code point
+            if (c == ending)
+            {
+                // Return the <string-token>.
+                token.value = end_value(m_position);
+                ++m_position;
+                return;
+            }
+
+            // newline
+            if (c == '\n')
+            {
+                // This is a parse error. Reconsume the current input code point, create a <bad-string-token>, and
+                // return it.
+                token.type = TokenType::BadString;
+                return;
+            }
+
+            // U+005C REVERSE SOLIDUS (\)
+            flush_value(m_position);
+            ++m_position;
+
+            // If the next input code point is EOF, do nothing.
+            // Otherwise, if the next input code point is a newline, consume it.
+            if (m_position >= m_input_length || peek() == '\n')
+            {
+                m_position = std::min(m_position + 1, m_input_length);
+                m_value_start = m_position;
+                continue;
+            }
+
+            // Otherwise, (the stream starts with a valid escape) consume an escaped code point and append the returned
+            // code point to the <string-token>'s value.
+            consume_escaped_code_point();
+        }
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-url-token
+    void Tokenizer::consume_url_token(Token& token)
+    {
+        // Initially create a <url-token> with its value set to the empty string.
+        token.type = TokenType::Url;
+        token.value = {};
+
+        // Consume as much whitespace as possible.
+        m_position = skip_whitespace(input(), m_position);
+        begin_value();
+
+        // Repeatedly consume the next input code point from the stream:
+        while (true)
+        {
+            // EOF
+            if (m_position >= m_input_length)
+            {
+                // This is a parse error. Return the <url-token>.
+                token.value = end_value(m_position);
+                return;
+            }
+
+            const char c = input()[m_position];
+
+            // U+0029 RIGHT PARENTHESIS ())
+            if (c == ')')
+            {
+                // Return the <url-token>.
+                token.value = end_value(m_position);
+                ++m_position;
+                return;
+            }
+
+            // whitespace
+            if (is_whitespace(c))
+            {
+                // Consume as much whitespace as possible.
+                const auto end = m_position;
+                m_position = skip_whitespace(input(), m_position);
+
+                // If the next input code point is U+0029 RIGHT PARENTHESIS ()) or EOF, consume it and return the
+                // <url-token> (if EOF was encountered, this is a parse error)
+                if (m_position >= m_input_length || peek() == ')')
+                {
+                    token.value = end_value(end);
+                    m_position = std::min(m_position + 1, m_input_length);
+                    return;
+                }
+
+                // otherwise, consume the remnants of a bad url, create a <bad-url-token>, and return it.
+                consume_bad_url_remnants();
+                token.type = TokenType::BadUrl;
+                return;
+            }
+
+            // U+0022 QUOTATION MARK (")
+            // U+0027 APOSTROPHE (')
+            // U+0028 LEFT PARENTHESIS (()
+            // non-printable code point
+            // U+005C REVERSE SOLIDUS (\), if the stream doesn't start with a valid escape
+            if (c == '"' || c == '\'' || c == '(' || is_non_printable_code_point(c) || (c == '\\' && !is_valid_escape()))
+            {
+                // This is a parse error. Consume the remnants of a bad url, create a <bad-url-token>, and return it.
+                consume_bad_url_remnants();
+                token.type = TokenType::BadUrl;
+                return;
+            }
+
+            // U+005C REVERSE SOLIDUS (\)
+            if (c == '\\')
+            {
+                // If the stream starts with a valid escape, consume an escaped code point and append the returned code
+                // point to the <url-token>'s value.
+                flush_value(m_position);
+                ++m_position;
+                consume_escaped_code_point();
+                continue;
+            }
+
+            // anything else
+            //     Append the current input code point to the <url-token>'s value.
+            ++m_position;
+        }
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-remnants-of-bad-url
+    void Tokenizer::consume_bad_url_remnants() noexcept
+    {
+        // Repeatedly consume the next input code point from the stream:
+        while (m_position < m_input_length)
+        {
+            // U+0029 RIGHT PARENTHESIS ())
+            if (peek() == ')')
+            {
+                ++m_position;
+                return;
+            }
+
+            // the input stream starts with a valid escape
+            //     Consume an escaped code point.
+            // NOTE: Skipping the code point after the backslash is enough, what's left of a hex escape can't be a ")".
+            m_position += is_valid_escape() ? 2 : 1;
+        }
+
+        m_position = m_input_length;
+    }
+
+    // https://drafts.csswg.org/css-syntax-3/#consume-token
+    auto Tokenizer::next_token() -> Token
+    {
+        // Consume comments.
+        consume_comments();
+
+        auto token = Token{ .offset = static_cast<uint32_t>(m_position) };
+
+        // Consume the next input code point.
+        // EOF
+        if (m_position >= m_input_length)
+        {
+            // Return an <EOF-token>.
+            token.type = TokenType::EndOfFile;
+            return token;
+        }
+
+        const char c = peek();
+
+        // whitespace
+        if (is_whitespace(c))
+        {
+            // Consume as much whitespace as possible. Return a <whitespace-token>.
+            m_position = skip_whitespace(input(), m_position);
+            token.type = TokenType::Whitespace;
+            return token;
+        }
+
+        auto simple_token = [&](TokenType type, size_t length = 1)
+        {
+            m_position += length;
+            token.type = type;
+            return token;
+        };
+
+        switch (c)
+        {
+            // U+0022 QUOTATION MARK (")
+            // U+0027 APOSTROPHE (')
+            case '"':
+            case '\'':
+            {
+                // Consume a string token and return it.
+                ++m_position;
+                consume_string_token(token, c);
+                return token;
+            }
+            // U+0023 NUMBER SIGN (#)
+            case '#':
+            {
+                // If the next input code point is an ident code point or the next two input code points are a valid
+                // escape, then:
+                if (is_ident_code_point(peek(1)) || is_valid_escape(1))
+                {
+                    ++m_position;
+
+                    // Create a <hash-token>.
+                    token.type = TokenType::Hash;
+
+                    // If the next 3 input code points would start an ident sequence, set the <hash-token>'s type flag to "id".
+                    token.flag = would_start_ident_sequence();
+
+                    // Consume an ident sequence, and set the <hash-token>'s value to the returned string.
+                    token.value = consume_ident_sequence();
+                    return token;
+                }
+
+                // Otherwise, return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            case '(': return simple_token(TokenType::OpenParen);
+            case ')': return simple_token(TokenType::CloseParen);
+            case ',': return simple_token(TokenType::Comma);
+            case ':': return simple_token(TokenType::Colon);
+            case ';': return simple_token(TokenType::Semicolon);
+            case '[': return simple_token(TokenType::OpenSquare);
+            case ']': return simple_token(TokenType::CloseSquare);
+            case '{': return simple_token(TokenType::OpenCurly);
+            case '}': return simple_token(TokenType::CloseCurly);
+            // U+002B PLUS SIGN (+)
+            // U+002E FULL STOP (.)
+            case '+':
+            case '.':
+            {
+                // If the input stream starts with a number, reconsume the current input code point, consume a numeric
+                // token, and return it.
+                if (would_start_number())
+                {
+                    consume_numeric_token(token);
+                    return token;
+                }
+
+                // Otherwise, return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            // U+002D HYPHEN-MINUS (-)
+            case '-':
+            {
+                // If the input stream starts with a number, reconsume the current input code point, consume a numeric
+                // token, and return it.
+                if (would_start_number())
+                {
+                    consume_numeric_token(token);
+                    return token;
+                }
+
+                // Otherwise, if the next 2 input code points are U+002D HYPHEN-MINUS U+003E GREATER-THAN SIGN (->),
+                // consume them and return a <CDC-token>.
+                if (peek(1) == '-' && peek(2) == '>')
+                {
+                    return simple_token(TokenType::CDC, 3);
+                }
+
+                // Otherwise, if the input stream starts with an ident sequence, reconsume the current input code point,
+                // consume an ident-like token, and return it.
+                if (would_start_ident_sequence())
+                {
+                    consume_ident_like_token(token);
+                    return token;
+                }
+
+                // Otherwise, return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            // U+003C LESS-THAN SIGN (<)
+            case '<':
+            {
+                // If the next 3 input code points are U+0021 EXCLAMATION MARK U+002D HYPHEN-MINUS U+002D HYPHEN-MINUS (!--),
+                // consume them and return a <CDO-token>.
+                if (peek(1) == '!' && peek(2) == '-' && peek(3) == '-')
+                {
+                    return simple_token(TokenType::CDO, 4);
+                }
+
+                // Otherwise, return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            // U+0040 COMMERCIAL AT (@)
+            case '@':
+            {
+                // If the next 3 input code points would start an ident sequence, consume an ident sequence, create an
+                // <at-keyword-token> with its value set to the returned value, and return it.
+                if (would_start_ident_sequence(1))
+                {
+                    ++m_position;
+                    token.type = TokenType::AtKeyword;
+                    token.value = consume_ident_sequence();
+                    return token;
+                }
+
+                // Otherwise, return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            // U+005C REVERSE SOLIDUS (\)
+            case '\\':
+            {
+                // If the input stream starts with a valid escape, reconsume the current input code point, consume an
+                // ident-like token, and return it.
+                if (is_valid_escape())
+                {
+                    consume_ident_like_token(token);
+                    return token;
+                }
+
+                // Otherwise, this is a parse error. Return a <delim-token> with its value set to the current input code point.
+                break;
+            }
+            default:
+            {
+                // digit
+                //     Reconsume the current input code point, consume a numeric token, and return it.
+                if (is_ascii_digit(c))
+                {
+                    consume_numeric_token(token);
+                    return token;
+                }
+
+                // ident-start code point
+                //     Reconsume the current input code point, consume an ident-like token, and return it.
+                if (is_ident_start_code_point(c))
+                {
+                    consume_ident_like_token(token);
+                    return token;
+                }
+
+                break;
+            }
+        }
+
+        // anything else
+        //     Return a <delim-token> with its value set to the current input code point.
+        // NOTE: Non-ASCII code points all start an ident sequence, so a delim is always a single byte.
+        token.value = { .offset = token.offset, .length = 1 };
+        return simple_token(TokenType::Delim);
+    }
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace Hanami::CSS {
+
+    // https://drafts.csswg.org/css-syntax-3/#tokenization
+    enum class TokenType : uint8_t
+    {
+        Ident,
+        Function,
+        AtKeyword,
+        Hash,
+        String,
+        BadString,
+        Url,
+        BadUrl,
+        Delim,
+        Number,
+        Percentage,
+        Dimension,
+        Whitespace,
+        CDO,
+        CDC,
+        Colon,
+        Semicolon,
+        Comma,
+        OpenSquare,
+        CloseSquare,
+        OpenParen,
+        CloseParen,
+        OpenCurly,
+        CloseCurly,
+        EndOfFile,
+    };
+
+    // A range of the text a token was tokenized from.
+    struct TextRange
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    // NOTE: Tokens don't own any text, they point into the text they were tokenized from (see Tokenizer), so they are
+    //       small enough to keep all of them in a flat list.
+    struct Token
+    {
+        TokenType type = TokenType::EndOfFile;
+
+        // The type flag of a hash token ("id" if set, "unrestricted" otherwise), or of a numeric token ("integer" if
+        // set, "number" otherwise).
+        bool flag = false;
+
+        // Where the token starts in the input.
+        uint32_t offset = 0;
+
+        // The name of an ident, function, at-keyword or hash token, the contents of a string or url token, the unit of
+        // a dimension token, or the code point of a delim token.
+        TextRange value{};
+
+        // The numeric value of a number, percentage or dimension token.
+        double number = 0.0;
+    };
+
+    class Tokenizer
+    {
+    public:
+        // Replaces CR LF, CR and FF with LF, and NUL with U+FFFD. The text is only rewritten if scanning it (16 bytes at
+        // a time where SSE2 is available) finds any of them.
+        // https://drafts.csswg.org/css-syntax-3/#input-preprocessing
+        static void preprocess(std::string& text);
+
+        // Tokenizes preprocessed text. The values of tokens with escapes in them don't exist in the input, they are
+        // appended to text after it instead, so every token value is a range of text.
+        explicit Tokenizer(std::string& text) noexcept;
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-token
+        [[nodiscard]]
+        auto next_token() -> Token;
+
+        // Tokenizes all of text, ending with an end-of-file token.
+        [[nodiscard]]
+        static auto tokenize(std::string& text) -> std::vector<Token>;
+
+    private:
+        [[nodiscard]]
+        auto input() const noexcept -> std::string_view { return { m_text.data(), m_input_length }; }
+
+        [[nodiscard]]
+        auto peek(size_t ahead = 0) const noexcept -> char
+        {
+            return m_position + ahead < m_input_length ? m_text[m_position + ahead] : '\0';
+        }
+
+        [[nodiscard]]
+        auto is_valid_escape(size_t ahead = 0) const noexcept -> bool;
+
+        [[nodiscard]]
+        auto would_start_ident_sequence(size_t ahead = 0) const noexcept -> bool;
+
+        [[nodiscard]]
+        auto would_start_number() const noexcept -> bool;
+
+        void consume_comments() noexcept;
+
+        // The value of the current token stays a range of the input until it has an escape in it, from then on it is
+        // copied into m_value, one run between escapes at a time.
+        void begin_value() noexcept;
+        void flush_value(size_t end);
+
+        [[nodiscard]]
+        auto end_value(size_t end) -> TextRange;
+
+        // https://drafts.csswg.org/css-syntax-3/#consume-escaped-code-point
+        void consume_escaped_code_point();
+
+        auto consume_ident_sequence() -> TextRange;
+        void consume_numeric_token(Token& token);
+        void consume_ident_like_token(Token& token);
+        void consume_string_token(Token& token, char ending);
+        void consume_url_token(Token& token);
+        void consume_bad_url_remnants() noexcept;
+
+        std::string& m_text;
+        size_t m_input_length = 0;
+        size_t m_position = 0;
+
+        // Where the part of the current value that hasn't been copied yet starts.
+        size_t m_value_start = 0;
+        bool m_copying_value = false;
+        std::string m_value;
+    };
+
+}
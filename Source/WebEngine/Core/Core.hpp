@@ -1,6 +1,7 @@
 #pragma once
 
 #include <span>
+#include <array>
 #include <string>
 #include <vector>
 #include <cctype>
@@ -54,6 +55,38 @@ namespace Hanami {
         return is_ascii_digit(c) || is_ascii_alpha(c);
     }
 
+    // https://infra.spec.whatwg.org/#ascii-whitespace
+    inline auto is_ascii_whitespace(char c) -> bool
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+    }
+
+    // https://infra.spec.whatwg.org/#split-on-ascii-whitespace
+    inline auto split_on_ascii_whitespace(std::string_view input) -> std::vector<std::string_view>
+    {
+        std::vector<std::string_view> tokens;
+
+        for (size_t position = 0; position < input.length();)
+        {
+            if (is_ascii_whitespace(input[position]))
+            {
+                ++position;
+                continue;
+            }
+
+            const auto start = position;
+
+            while (position < input.length() && !is_ascii_whitespace(input[position]))
+            {
+                ++position;
+            }
+
+            tokens.push_back(input.substr(start, position - start));
+        }
+
+        return tokens;
+    }
+
     // https://infra.spec.whatwg.org/#surrogate
     inline auto is_unicode_surrogate(uint32_t codepoint) -> bool
     {
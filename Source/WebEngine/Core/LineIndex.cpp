@@ -0,0 +1,59 @@
+#include "LineIndex.hpp"
+
+#include <bit>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define HANAMI_HAS_SSE2 1
+#endif
+
+namespace Hanami {
+
+    auto count_newlines(std::string_view input) noexcept -> size_t
+    {
+        size_t count = 0;
+        size_t i = 0;
+
+#if defined(HANAMI_HAS_SSE2)
+        const auto newline = _mm_set1_epi8('\n');
+
+        for (; i + 16 <= input.length(); i += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+            const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+            count += static_cast<size_t>(std::popcount(mask));
+        }
+#endif
+
+        for (; i < input.length(); ++i)
+        {
+            count += input[i] == '\n';
+        }
+
+        return count;
+    }
+
+    auto LineIndex::position_of(size_t offset) -> SourcePosition
+    {
+        offset = std::min(offset, m_input.length());
+
+        if (m_line_starts.empty())
+        {
+            m_line_starts.reserve(count_newlines(m_input) + 1);
+            m_line_starts.push_back(0);
+
+            for (auto newline = m_input.find('\n'); newline != std::string_view::npos; newline = m_input.find('\n', newline + 1))
+            {
+                m_line_starts.push_back(newline + 1);
+            }
+        }
+
+        // The last line starting at or before offset.
+        const auto line = std::ranges::upper_bound(m_line_starts, offset) - m_line_starts.begin() - 1;
+        const auto line_start = m_line_starts[static_cast<size_t>(line)];
+
+        return { .line = static_cast<size_t>(line) + 1, .column = offset - line_start + 1 };
+    }
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace Hanami {
+
+    // 1-based line and column, columns count bytes.
+    struct SourcePosition
+    {
+        size_t line = 1;
+        size_t column = 1;
+    };
+
+    // Counts the U+000A LF characters in input, 16 bytes at a time where SSE2 is available.
+    [[nodiscard]]
+    auto count_newlines(std::string_view input) noexcept -> size_t;
+
+    // Maps byte offsets to lines and columns.
+    //
+    // The offsets the lines start at are found on the first lookup rather than up front, a lookup binary searches them.
+    class LineIndex
+    {
+    public:
+        explicit LineIndex(std::string_view input) noexcept
+            : m_input(input)
+        {
+        }
+
+        [[nodiscard]]
+        auto position_of(size_t offset) -> SourcePosition;
+
+    private:
+        std::string_view m_input;
+        std::vector<size_t> m_line_starts;
+    };
+
+}
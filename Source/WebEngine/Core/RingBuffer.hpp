@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Hanami {
+
+    // Lock-free single-producer / single-consumer ring buffer.
+    //
+    // Slots are reused in place: the producer fills the slot returned by begin_write() and publishes it with end_write(),
+    // the consumer mirrors this with begin_read() and end_read(). This lets slots hold containers whose capacity survives
+    // being recycled, instead of moving values in and out of the buffer.
+    template<typename T, size_t Capacity>
+    class SPSCRingBuffer
+    {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // Producer only. Blocks until a slot is free.
+        [[nodiscard]]
+        auto begin_write() noexcept -> T&
+        {
+            const auto write = m_write_index.load(std::memory_order_relaxed);
+            auto read = m_read_index.load(std::memory_order_acquire);
+
+            while (write - read == Capacity)
+            {
+                m_read_index.wait(read, std::memory_order_acquire);
+                read = m_read_index.load(std::memory_order_acquire);
+            }
+
+            return m_slots[write & (Capacity - 1)];
+        }
+
+        // Producer only. Publishes the slot returned by the last begin_write().
+        void end_write() noexcept
+        {
+            m_write_index.store(m_write_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            m_write_index.notify_one();
+        }
+
+        // Producer only. Blocks until the consumer has released every published slot.
+        void wait_until_drained() noexcept
+        {
+            const auto write = m_write_index.load(std::memory_order_relaxed);
+            auto read = m_read_index.load(std::memory_order_acquire);
+
+            while (read != write)
+            {
+                m_read_index.wait(read, std::memory_order_acquire);
+                read = m_read_index.load(std::memory_order_acquire);
+            }
+        }
+
+        // Consumer only. Blocks until a published slot is available.
+        [[nodiscard]]
+        auto begin_read() noexcept -> T&
+        {
+            const auto read = m_read_index.load(std::memory_order_relaxed);
+            auto write = m_write_index.load(std::memory_order_acquire);
+
+            while (write == read)
+            {
+                m_write_index.wait(write, std::memory_order_acquire);
+                write = m_write_index.load(std::memory_order_acquire);
+            }
+
+            return m_slots[read & (Capacity - 1)];
+        }
+
+        // Consumer only. Hands the slot returned by the last begin_read() back to the producer.
+        void end_read() noexcept
+        {
+            m_read_index.store(m_read_index.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            m_read_index.notify_one();
+        }
+
+    private:
+        std::array<T, Capacity> m_slots{};
+
+        // Kept on separate cache lines so the producer and consumer don't false share.
+        alignas(64) std::atomic<size_t> m_write_index = 0;
+        alignas(64) std::atomic<size_t> m_read_index = 0;
+    };
+
+}
@@ -0,0 +1,164 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Hanami {
+
+    static thread_local const ThreadPool* s_current_pool = nullptr;
+    static thread_local uint32_t s_current_worker_index = 0;
+
+    ThreadPool::ThreadPool(uint32_t thread_count)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        m_queues.reserve(thread_count);
+
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            m_queues.emplace_back(std::make_unique<WorkerQueue>());
+        }
+
+        m_threads.reserve(thread_count);
+
+        for (uint32_t i = 0; i < thread_count; ++i)
+        {
+            m_threads.emplace_back([this, i](std::stop_token stop_token)
+            {
+                worker_main(stop_token, i);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        for (auto& thread : m_threads)
+        {
+            thread.request_stop();
+        }
+
+        // Join before any of the synchronization primitives are destroyed.
+        m_threads.clear();
+    }
+
+    void ThreadPool::submit(Task task)
+    {
+        const auto queue_index = s_current_pool == this
+            ? s_current_worker_index
+            : m_next_queue.fetch_add(1, std::memory_order_relaxed) % static_cast<uint32_t>(m_queues.size());
+
+        {
+            auto& queue = *m_queues[queue_index];
+            std::scoped_lock lock(queue.mutex);
+            queue.tasks.emplace_back(std::move(task));
+        }
+
+        // NOTE: Counted once the task is queued, a worker has to claim a task from the count before it takes one from
+        //       a queue (see worker_main()), so it can't run before it's been accounted for either.
+        {
+            std::scoped_lock lock(m_mutex);
+            ++m_queued_tasks;
+            ++m_unfinished_tasks;
+        }
+
+        m_task_available.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_all_done.wait(lock, [this] { return m_unfinished_tasks == 0; });
+    }
+
+    auto ThreadPool::current_worker_index() noexcept -> std::optional<uint32_t>
+    {
+        if (!s_current_pool)
+        {
+            return std::nullopt;
+        }
+
+        return s_current_worker_index;
+    }
+
+    auto ThreadPool::try_pop_task(uint32_t worker_index) -> std::optional<Task>
+    {
+        const auto queue_count = static_cast<uint32_t>(m_queues.size());
+
+        for (uint32_t i = 0; i < queue_count; ++i)
+        {
+            auto& queue = *m_queues[(worker_index + i) % queue_count];
+            std::scoped_lock lock(queue.mutex);
+
+            if (queue.tasks.empty())
+            {
+                continue;
+            }
+
+            Task task;
+
+            // NOTE: Our own queue runs in submission order, stealing takes the most recently queued task instead
+            //       to keep out of the owner's way.
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            else
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+
+            return task;
+        }
+
+        return std::nullopt;
+    }
+
+    void ThreadPool::worker_main(std::stop_token stop_token, uint32_t worker_index)
+    {
+        s_current_pool = this;
+        s_current_worker_index = worker_index;
+
+        while (true)
+        {
+            // Claim one of the queued tasks, so no other worker wakes up for it.
+            {
+                std::unique_lock lock(m_mutex);
+
+                if (!m_task_available.wait(lock, stop_token, [this] { return m_queued_tasks > 0; }))
+                {
+                    // Stop requested
+                    return;
+                }
+
+                --m_queued_tasks;
+            }
+
+            // NOTE: There are at least as many queued tasks as workers that claimed one, but while we look through the
+            //       queues the others may take the tasks ahead of us and leave us one in a queue we've already looked
+            //       at, so we look again.
+            auto task = try_pop_task(worker_index);
+
+            while (!task)
+            {
+                std::this_thread::yield();
+                task = try_pop_task(worker_index);
+            }
+
+            (*task)();
+
+            {
+                std::scoped_lock lock(m_mutex);
+
+                if (--m_unfinished_tasks == 0)
+                {
+                    m_all_done.notify_all();
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <condition_variable>
+
+namespace Hanami {
+
+    // Work-stealing thread pool.
+    //
+    // Every worker owns a queue. Tasks submitted from outside the pool are spread over the queues round-robin, tasks
+    // submitted from inside a task go to the calling worker's own queue. Workers run their own queue front to back,
+    // and when it runs dry they steal from the back of the other queues, so one long task doesn't hold up the tasks
+    // queued behind it.
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // A thread count of 0 uses one thread per hardware thread.
+        explicit ThreadPool(uint32_t thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+        void submit(Task task);
+
+        // Blocks until every submitted task has finished running.
+        void wait();
+
+        [[nodiscard]]
+        auto thread_count() const noexcept -> uint32_t { return static_cast<uint32_t>(m_threads.size()); }
+
+        // Index of the calling thread within its pool, or std::nullopt if it isn't a pool worker.
+        // Useful for indexing per-worker state, e.g. scratch buffers that are reused between tasks.
+        [[nodiscard]]
+        static auto current_worker_index() noexcept -> std::optional<uint32_t>;
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void worker_main(std::stop_token stop_token, uint32_t worker_index);
+
+        auto try_pop_task(uint32_t worker_index) -> std::optional<Task>;
+
+    private:
+        std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+        std::atomic<uint32_t> m_next_queue = 0;
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_task_available;
+        std::condition_variable m_all_done;
+        uint32_t m_queued_tasks = 0;
+        uint32_t m_unfinished_tasks = 0;
+
+        std::vector<std::jthread> m_threads;
+    };
+
+}
@@ -1,16 +1,79 @@
 #include "Document.hpp"
 #include "CharacterData.hpp"
 
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/HTML/IncrementalParse.hpp"
+
 #include "Kori/Core.hpp"
 
 #include <print>
 
 namespace Hanami::DOM {
 
+    Document::Document() noexcept
+        : Node(NodeType::Document)
+    {
+    }
+
+    Document::~Document() noexcept = default;
+
+    auto Document::reparse_range(const TextEdit& edit) -> Node*
+    {
+        auto* rebuilt = HTML::Parser::reparse_range(*this, edit);
+
+        if (rebuilt)
+        {
+            rebuilt->set_needs_layout();
+            ++m_version;
+        }
+
+        return rebuilt;
+    }
+
+    auto Document::source_range(const Node& node) const noexcept -> std::optional<SourceRange>
+    {
+        if (node.id() >= m_source_ranges.size())
+        {
+            return std::nullopt;
+        }
+
+        const auto& stored = m_source_ranges[node.id()];
+
+        return SourceRange{
+            .begin = shifted_source_offset(stored.range.begin, stored.shifts_applied),
+            .end = shifted_source_offset(stored.range.end, stored.shifts_applied),
+        };
+    }
+
+    auto Document::shifted_source_offset(size_t position, size_t shifts_applied) const noexcept -> size_t
+    {
+        for (size_t i = shifts_applied; i < m_source_shifts.size(); ++i)
+        {
+            const auto& shift = m_source_shifts[i];
+
+            if (position >= shift.position)
+            {
+                position = static_cast<size_t>(static_cast<ptrdiff_t>(position) + shift.delta);
+            }
+        }
+
+        return position;
+    }
+
+    auto Document::source_position(size_t offset) const -> SourcePosition
+    {
+        if (!m_line_index)
+        {
+            m_line_index.emplace(m_source);
+        }
+
+        return m_line_index->position_of(offset);
+    }
+
     void Document::print() const noexcept
     {
-        static int32_t num_indents = -1;
-        static bool exclude_empty_cdata = false;
+        int32_t num_indents = -1;
+        bool exclude_empty_cdata = false;
 
         auto print_node = [&](this auto&& self, const Node* node) -> void
         {
@@ -3,9 +3,12 @@
 #include "Node.hpp"
 #include "Element.hpp"
 
+#include "WebEngine/Core/LineIndex.hpp"
+
 namespace Hanami::HTML {
 
     class Parser;
+    struct IncrementalParseState;
 
 }
 
@@ -35,13 +38,21 @@ namespace Hanami::DOM {
         std::string m_system_id;
     };
 
+    // Replaces removed_length characters of the source at offset with inserted.
+    struct TextEdit
+    {
+        size_t offset = 0;
+        size_t removed_length = 0;
+        std::string inserted{};
+    };
+
     // https://html.spec.whatwg.org/multipage/dom.html#document
     class Document : public Node
     {
     public:
-        Document() noexcept
-            : Node(NodeType::Document)
-        {}
+        // NOTE: Both defined out of line, where HTML::IncrementalParseState is complete.
+        Document() noexcept;
+        ~Document() noexcept override;
 
         [[nodiscard]]
         auto head() const noexcept -> Element* { return m_head; }
@@ -51,10 +62,66 @@ namespace Hanami::DOM {
 
         void print() const noexcept;
 
+        // Incremented by every change to the tree or its character data, so anything derived from the document (e.g.
+        // the text prepared for rendering) can tell when it has to be rebuilt.
+        [[nodiscard]]
+        auto version() const noexcept -> uint64_t { return m_version; }
+
+        // Applies edit to the source and re-parses only the part of the tree it affects, falling back to the parent of
+        // the innermost element containing the edit (and ultimately the whole document) whenever the new tokens don't
+        // line up with the old tree again by the end of that element.
+        // Returns the node whose children were rebuilt, or nullptr if the document wasn't parsed with HTML::ParseOptions::incremental.
+        auto reparse_range(const TextEdit& edit) -> Node*;
+
+        // The source the document was parsed from (with newlines normalized), with every edit applied.
+        [[nodiscard]]
+        auto source() const noexcept -> std::string_view { return m_source; }
+
+        // Where in the source node was parsed from, std::nullopt for nodes that weren't created by the parser.
+        [[nodiscard]]
+        auto source_range(const Node& node) const noexcept -> std::optional<SourceRange>;
+
+        // NOTE: Lines are counted the first time this is called (and after an edit), which isn't thread-safe.
+        [[nodiscard]]
+        auto source_position(size_t offset) const -> SourcePosition;
+
     private:
         Element* m_head = nullptr;
         Element* m_body = nullptr;
         bool m_scripting = false;
+        uint64_t m_version = 0;
+
+        std::string m_source;
+
+        // A node's source range as of the first shifts_applied entries of m_source_shifts.
+        struct StoredSourceRange
+        {
+            SourceRange range;
+            uint32_t shifts_applied = 0;
+        };
+
+        // Everything at or after position moved by delta, logged by re-parses rather than applied to every range after
+        // the edit right away. Ranges catch up when they're read, see source_range().
+        struct SourceShift
+        {
+            size_t position = 0;
+            ptrdiff_t delta = 0;
+
+            // The edit's removed text ends at position.
+            size_t removed_length = 0;
+        };
+
+        // Applies the shifts logged after the first shifts_applied to position.
+        [[nodiscard]]
+        auto shifted_source_offset(size_t position, size_t shifts_applied) const noexcept -> size_t;
+
+        // Indexed by node id.
+        std::vector<StoredSourceRange> m_source_ranges;
+        std::vector<SourceShift> m_source_shifts;
+
+        mutable std::optional<LineIndex> m_line_index;
+
+        std::unique_ptr<HTML::IncrementalParseState> m_incremental_state;
 
         friend HTML::Parser;
         friend class Node;
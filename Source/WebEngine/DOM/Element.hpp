@@ -2,6 +2,8 @@
 
 #include "Node.hpp"
 
+#include "WebEngine/CSS/StyleSheet.hpp"
+
 namespace Hanami::DOM {
 
     // https://dom.spec.whatwg.org/#interface-element
@@ -20,6 +22,20 @@ namespace Hanami::DOM {
         // A non-empty string.
         std::string local_name;
 
+        // https://dom.spec.whatwg.org/#concept-attribute
+        // NOTE: Attributes aren't nodes (yet), just the names and values the parser found.
+        struct Attribute
+        {
+            std::string local_name;
+            std::string value;
+        };
+
+        std::vector<Attribute> attributes{};
+
+        // The declarations of the style attribute, if there is one.
+        // https://drafts.csswg.org/cssom/#dom-elementcssinlinestyle-style
+        std::unique_ptr<CSS::DeclarationBlock> inline_style{};
+
         // TODO(Peter): Custom Elements
         // custom element registry
         // Null or a CustomElementRegistry object.
@@ -35,6 +51,21 @@ namespace Hanami::DOM {
         {
             return namespace_uri == value;
         }
+
+        // https://dom.spec.whatwg.org/#concept-element-attributes-get-by-name
+        [[nodiscard]]
+        auto get_attribute(std::string_view name) const noexcept -> std::optional<std::string_view>
+        {
+            for (const auto& attribute : attributes)
+            {
+                if (attribute.local_name == name)
+                {
+                    return attribute.value;
+                }
+            }
+
+            return std::nullopt;
+        }
     };
 
 }
@@ -0,0 +1,51 @@
+#include "HTMLElement.hpp"
+
+#include "Text.hpp"
+#include "WebEngine/CSS/Parser.hpp"
+
+namespace Hanami::DOM {
+
+    void HTMLStyleElement::update_style_block()
+    {
+        // 1. Let element be the style element.
+        // 2. If element has an associated CSS style sheet, remove the CSS style sheet in question.
+        m_sheet.reset();
+
+        // 3. If element is not connected, then return.
+        // NOTE: The parser is the only one updating style blocks, when popping the element, which is connected then.
+
+        // 4. If element's type attribute is present and its value is neither the empty string nor an ASCII
+        //    case-insensitive match for "text/css", then return.
+        if (auto type = get_attribute("type"); type && !type->empty() && !equals_case_insensitive(*type, "text/css"))
+        {
+            return;
+        }
+
+        // 5. If the Should element's inline behavior be blocked by Content Security Policy? algorithm returns "Blocked"
+        //    when executed upon the style element, "style", and the style element's child text content, then return.
+
+        // 6. Create a CSS style sheet with the following properties:
+        //    type: text/css
+        //    owner node: element
+        //    media: The media attribute of element.
+        //    title: The title attribute of element, if element is in a document tree, or the empty string otherwise.
+        //    alternate flag: Unset.
+        //    origin-clean flag: Set.
+        //    location, parent CSS style sheet, owner CSS rule: null
+        //    disabled flag: Left at its default value.
+        //    CSS rules: Left uninitialized.
+        // NOTE: Only the rules are kept, parsed from the child text content.
+        std::string text;
+
+        for (const auto* child : children())
+        {
+            if (child->type() == NodeType::Text)
+            {
+                text += static_cast<const Text*>(child)->data();
+            }
+        }
+
+        m_sheet = std::make_unique<CSS::StyleSheet>(CSS::Parser::parse_style_sheet(std::move(text)));
+    }
+
+}
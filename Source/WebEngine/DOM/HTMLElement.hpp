@@ -19,4 +19,23 @@ namespace Hanami::DOM {
             : HTMLElement() {}
     };
 
+    // https://html.spec.whatwg.org/multipage/semantics.html#the-style-element
+    class HTMLStyleElement : public HTMLElement
+    {
+    public:
+        HTMLStyleElement() noexcept
+            : HTMLElement() {}
+
+        // Parses the element's child text content into its style sheet.
+        // https://html.spec.whatwg.org/multipage/semantics.html#update-a-style-block
+        void update_style_block();
+
+        // The element's CSS style sheet, null if it doesn't have one.
+        [[nodiscard]]
+        auto sheet() const noexcept -> const CSS::StyleSheet* { return m_sheet.get(); }
+
+    private:
+        std::unique_ptr<CSS::StyleSheet> m_sheet;
+    };
+
 }
@@ -26,6 +26,14 @@ namespace Hanami::DOM {
         return *iter;
     }
 
+    Node::~Node() noexcept
+    {
+        for (auto* child : m_child_nodes)
+        {
+            delete child;
+        }
+    }
+
     auto Node::first_child() const noexcept -> Node*
     {
         if (m_child_nodes.empty())
@@ -73,6 +81,13 @@ namespace Hanami::DOM {
         node->m_document = m_type == NodeType::Document ? dynamic_cast<Document*>(this) : m_document;
         node->m_parent = this;
 
+        set_needs_layout();
+
+        if (node->m_document)
+        {
+            ++node->m_document->m_version;
+        }
+
         // 5. Return node.
         return node;
     }
@@ -83,6 +98,17 @@ namespace Hanami::DOM {
         return insert_before(node, nullptr);
     }
 
+    void Node::set_needs_layout() noexcept
+    {
+        m_needs_layout = true;
+
+        // NOTE: An ancestor that already has the bit set has had it set on its own ancestors as well.
+        for (auto* ancestor = m_parent; ancestor && !ancestor->m_child_needs_layout; ancestor = ancestor->m_parent)
+        {
+            ancestor->m_child_needs_layout = true;
+        }
+    }
+
     // https://html.spec.whatwg.org/multipage/infrastructure.html#html-elements
     auto Node::is_html_element() const noexcept -> bool
     {
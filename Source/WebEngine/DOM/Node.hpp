@@ -72,11 +72,21 @@ namespace Hanami::DOM {
 
     class Document;
 
+    // Offsets into the (normalized) source a node was parsed from, end is exclusive.
+    struct SourceRange
+    {
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    static constexpr uint32_t InvalidNodeId = ~0u;
+
     // https://dom.spec.whatwg.org/#node
     class Node // : EventTarget
     {
     public:
-        virtual ~Node() noexcept = default;
+        // A node owns its children.
+        virtual ~Node() noexcept;
 
         [[nodiscard]]
         auto first_child() const noexcept -> Node*;
@@ -99,6 +109,27 @@ namespace Hanami::DOM {
         [[nodiscard]]
         auto type() const noexcept -> NodeType { return m_type; }
 
+        // Index of the node in its document's side tables, e.g. Document::source_range(). InvalidNodeId if the node
+        // wasn't created by the parser.
+        [[nodiscard]]
+        auto id() const noexcept -> uint32_t { return m_id; }
+
+        // Layout dirty bits, see Layout::LayoutTree::update(). A node needs layout when its children or its character
+        // data changed, and its ancestors then have a child that needs layout. Both are cleared by layout.
+        [[nodiscard]]
+        auto needs_layout() const noexcept -> bool { return m_needs_layout; }
+
+        [[nodiscard]]
+        auto child_needs_layout() const noexcept -> bool { return m_child_needs_layout; }
+
+        void set_needs_layout() noexcept;
+
+        void clear_needs_layout() noexcept
+        {
+            m_needs_layout = false;
+            m_child_needs_layout = false;
+        }
+
     protected:
         Node(NodeType type) noexcept
             : m_type(type)
@@ -107,6 +138,9 @@ namespace Hanami::DOM {
 
     private:
         NodeType m_type = NodeType::Invalid;
+        bool m_needs_layout = false;
+        bool m_child_needs_layout = false;
+        uint32_t m_id = InvalidNodeId;
         Document* m_document = nullptr;
 
         Node* m_parent = nullptr;
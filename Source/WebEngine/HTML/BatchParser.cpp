@@ -0,0 +1,144 @@
+#include "BatchParser.hpp"
+
+#include "WebEngine/Core/ThreadPool.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <algorithm>
+
+namespace Hanami::HTML {
+
+    auto BatchParseStats::megabytes_per_second() const noexcept -> double
+    {
+        return elapsed.count() > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / elapsed.count() : 0.0;
+    }
+
+    auto BatchParseStats::documents_per_second() const noexcept -> double
+    {
+        return elapsed.count() > 0.0 ? static_cast<double>(documents) / elapsed.count() : 0.0;
+    }
+
+    auto BatchParseStats::nodes_per_second() const noexcept -> double
+    {
+        return elapsed.count() > 0.0 ? static_cast<double>(nodes) / elapsed.count() : 0.0;
+    }
+
+    static auto count_nodes(const Node* node) -> size_t
+    {
+        size_t count = 1;
+
+        for (const auto* child : node->children())
+        {
+            count += count_nodes(child);
+        }
+
+        return count;
+    }
+
+    static auto read_file(const std::filesystem::path& path, size_t size, std::string& out) -> bool
+    {
+        std::ifstream stream(path, std::ios::binary);
+
+        if (!stream)
+        {
+            return false;
+        }
+
+        out.resize(size);
+        stream.read(out.data(), static_cast<std::streamsize>(size));
+        out.resize(static_cast<size_t>(stream.gcount()));
+
+        return true;
+    }
+
+    auto parse_batch(
+        std::span<const std::filesystem::path> paths,
+        const ParseOptions& options,
+        uint32_t thread_count,
+        const BatchDocumentFunc& on_document) -> BatchParseStats
+    {
+        struct BatchFile
+        {
+            const std::filesystem::path* path;
+            size_t size;
+        };
+
+        // Per-worker state, reused for every document the worker parses.
+        struct Worker
+        {
+            Parser parser;
+            std::string file_contents;
+        };
+
+        const auto start_time = std::chrono::steady_clock::now();
+
+        std::vector<BatchFile> files;
+        files.reserve(paths.size());
+
+        std::atomic<size_t> failed_documents = 0;
+
+        for (const auto& path : paths)
+        {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(path, error);
+
+            if (error)
+            {
+                failed_documents.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            files.push_back({ &path, static_cast<size_t>(size) });
+        }
+
+        std::ranges::sort(files, std::greater{}, &BatchFile::size);
+
+        auto document_options = options;
+        document_options.tokenizer_threads = 1;
+        document_options.preload_queue = nullptr;
+        document_options.parse_errors = nullptr;
+
+        ThreadPool pool(thread_count);
+        auto workers = std::vector<Worker>(pool.thread_count());
+
+        std::atomic<size_t> documents = 0;
+        std::atomic<size_t> bytes = 0;
+        std::atomic<size_t> nodes = 0;
+
+        for (const auto& file : files)
+        {
+            pool.submit([&]
+            {
+                auto& worker = workers[*ThreadPool::current_worker_index()];
+
+                if (!read_file(*file.path, file.size, worker.file_contents))
+                {
+                    failed_documents.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                auto document = std::unique_ptr<Document>(worker.parser.parse(worker.file_contents, document_options));
+
+                documents.fetch_add(1, std::memory_order_relaxed);
+                bytes.fetch_add(worker.file_contents.length(), std::memory_order_relaxed);
+                nodes.fetch_add(count_nodes(document.get()), std::memory_order_relaxed);
+
+                if (on_document)
+                {
+                    on_document(*file.path, std::move(document));
+                }
+            });
+        }
+
+        pool.wait();
+
+        return {
+            .documents = documents.load(),
+            .failed_documents = failed_documents.load(),
+            .bytes = bytes.load(),
+            .nodes = nodes.load(),
+            .elapsed = std::chrono::steady_clock::now() - start_time,
+        };
+    }
+
+}
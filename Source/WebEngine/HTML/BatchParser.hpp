@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Parser.hpp"
+
+#include <span>
+#include <chrono>
+#include <functional>
+
+namespace Hanami::HTML {
+
+    struct BatchParseStats
+    {
+        size_t documents = 0;
+        size_t failed_documents = 0;
+        size_t bytes = 0;
+        size_t nodes = 0;
+        std::chrono::duration<double> elapsed{};
+
+        [[nodiscard]]
+        auto megabytes_per_second() const noexcept -> double;
+
+        [[nodiscard]]
+        auto documents_per_second() const noexcept -> double;
+
+        [[nodiscard]]
+        auto nodes_per_second() const noexcept -> double;
+    };
+
+    // Called from the worker threads with every parsed document, taking ownership of it.
+    using BatchDocumentFunc = std::function<void(const std::filesystem::path& path, std::unique_ptr<Document> document)>;
+
+    // Parses every file on a work-stealing thread pool, each worker reusing one parser (and its buffers) for all the
+    // documents it parses. Files are started largest first so a single huge file doesn't end up being the last one
+    // running. If no callback is given the documents are destroyed once their nodes have been counted.
+    //
+    // NOTE: Parallel tokenization is disabled for the documents, the batch already keeps every thread busy.
+    //       The preload queue is ignored as well, a queue is closed as soon as the first document finishes scanning.
+    //       So are the parse errors, which would end up mixed together from all the documents.
+    auto parse_batch(
+        std::span<const std::filesystem::path> paths,
+        const ParseOptions& options = {},
+        uint32_t thread_count = 0,
+        const BatchDocumentFunc& on_document = {}) -> BatchParseStats;
+
+}
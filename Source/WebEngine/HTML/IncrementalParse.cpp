@@ -0,0 +1,435 @@
+#include "IncrementalParse.hpp"
+
+#include "WebEngine/DOM/HTMLElement.hpp"
+
+#include "Kori/Core.hpp"
+
+namespace Hanami::HTML {
+
+    // Past this many logged shifts, reading a source range costs more than applying the log to every range once.
+    static constexpr size_t MaxPendingSourceShifts = 64;
+
+    auto Parser::reparse_range(Document& document, const TextEdit& edit) -> Node*
+    {
+        auto* state = document.m_incremental_state.get();
+
+        if (!state)
+        {
+            return nullptr;
+        }
+
+        auto& source = document.m_source;
+
+        std::string inserted;
+        normalize_input_stream(edit.inserted, inserted);
+
+        // NOTE: Only ever widened, whatever the edit removed may still be elsewhere in the source.
+        state->input_properties.contains_nul = state->input_properties.contains_nul || Tokenizer::scan_input(inserted).contains_nul;
+
+        const auto offset = std::min(edit.offset, source.length());
+        const auto removed_length = std::min(edit.removed_length, source.length() - offset);
+        const auto edit_end = offset + removed_length;
+        const auto delta = static_cast<ptrdiff_t>(inserted.length()) - static_cast<ptrdiff_t>(removed_length);
+
+        source.replace(offset, removed_length, inserted);
+        document.m_line_index.reset();
+
+        // Find the innermost element whose contents contain the edit, the edit has to start after its start tag,
+        // and end before its end has been reached.
+        // NOTE: Children are searched as if they were in source order, which nodes moved around by the tree builder
+        //       (e.g. foster parenting) aren't. Missing the element containing the edit because of that only means
+        //       one of its ancestors gets re-parsed instead.
+        Element* innermost = nullptr;
+
+        for (Node* node = &document; node;)
+        {
+            Node* next = nullptr;
+
+            const auto& children = node->m_child_nodes;
+            const auto candidate = std::ranges::partition_point(children, [&](const Node* child)
+            {
+                const auto range = document.source_range(*child);
+                return !range || range->begin < offset;
+            });
+
+            if (candidate != children.begin())
+            {
+                auto* child = *std::prev(candidate);
+                const auto range = document.source_range(*child);
+
+                if (child->is_element() && range && edit_end < range->end)
+                {
+                    next = child;
+                }
+            }
+
+            if (next)
+            {
+                innermost = static_cast<Element*>(next);
+            }
+
+            node = next;
+        }
+
+        for (auto* element = innermost; element; element = dynamic_cast<Element*>(element->m_parent))
+        {
+            if (try_reparse_element(document, *element, offset, edit_end, delta))
+            {
+                return element;
+            }
+        }
+
+        return reparse_document(document);
+    }
+
+    auto Parser::try_reparse_element(Document& document, Element& element, size_t edit_offset, size_t edit_end, ptrdiff_t delta) -> bool
+    {
+        auto& state = *document.m_incremental_state;
+
+        const auto checkpoint_it = state.checkpoints.find(&element);
+
+        if (checkpoint_it == state.checkpoints.end() || !checkpoint_it->second.end_tag_insertion_mode)
+        {
+            return false;
+        }
+
+        auto checkpoint = checkpoint_it->second;
+        checkpoint.tokenizer.offset = document.shifted_source_offset(checkpoint.tokenizer.offset, checkpoint.shifts_applied);
+
+        const auto element_range = document.source_range(element);
+
+        if (!element_range)
+        {
+            return false;
+        }
+
+        if (checkpoint.tokenizer.offset > edit_offset)
+        {
+            // The edit touches the start tag.
+            return false;
+        }
+
+        // The stack of open elements when the element's contents started, i.e. the element and its ancestors.
+        std::vector<Element*> ancestors;
+
+        for (auto* node = &element; node; node = dynamic_cast<Element*>(node->m_parent))
+        {
+            // NOTE: Foreign content changes how the contents are tokenized, leave that to a full parse.
+            if (!node->is_in_namespace(html_namespace))
+            {
+                return false;
+            }
+
+            ancestors.insert(ancestors.begin(), node);
+        }
+
+        // The contents are re-parsed with stand-ins for the element and its ancestors, so whatever the new tokens
+        // do to the ancestors can be thrown away if they turn out not to resync with the old tree.
+        std::unique_ptr<Element> stand_in_root;
+        std::vector<Element*> open_elements;
+
+        for (auto* ancestor : ancestors)
+        {
+            auto* stand_in = new Element();
+            stand_in->namespace_uri = ancestor->namespace_uri;
+            stand_in->namespace_prefix = ancestor->namespace_prefix;
+            stand_in->local_name = ancestor->local_name;
+            stand_in->m_document = &document;
+
+            if (open_elements.empty())
+            {
+                stand_in_root.reset(stand_in);
+            }
+            else
+            {
+                // NOTE: Not using append_child, the stand-ins mustn't update the document's head or body.
+                stand_in->m_parent = open_elements.back();
+                open_elements.back()->m_child_nodes.push_back(stand_in);
+            }
+
+            open_elements.push_back(stand_in);
+        }
+
+        auto* new_element = open_elements.back();
+        const auto depth = open_elements.size();
+
+        ElementCheckpoints new_checkpoints;
+
+        Parser parser;
+        parser.m_document.reset(&document);
+        KoriDefer { (void)parser.m_document.release(); };
+
+        parser.m_open_elements = std::move(open_elements);
+        parser.m_insertion_mode = checkpoint.insertion_mode;
+        parser.m_original_insertion_mode = checkpoint.original_insertion_mode;
+        parser.m_frameset_ok = FramesetOK::NotOk;
+        parser.m_element_checkpoints = &new_checkpoints;
+        parser.m_token_range = { checkpoint.tokenizer.offset, checkpoint.tokenizer.offset };
+
+        // Nodes created by the re-parse get ids from here on, the ranges before it belong to the old tree.
+        auto& source_ranges = document.m_source_ranges;
+        const auto first_new_id = source_ranges.size();
+
+        // The old end tag, after the edit.
+        const auto resync_offset = static_cast<size_t>(static_cast<ptrdiff_t>(element_range->end) + delta);
+
+        bool resynced = false;
+        bool failed = false;
+
+        parser.m_tokenizer.reset(document.m_source, [&](const Token& token)
+        {
+            if (resynced || failed)
+            {
+                return;
+            }
+
+            const auto token_end = parser.m_tokenizer.current_offset();
+
+            // We're back in sync once the element's end tag shows up where it used to be, with the tree builder in the same state.
+            if (token_end == resync_offset &&
+                token_is_end_tag(token, element.local_name) &&
+                parser.current_node() == new_element &&
+                parser.m_insertion_mode == *checkpoint.end_tag_insertion_mode)
+            {
+                resynced = true;
+                parser.m_tokenizer.pause();
+                return;
+            }
+
+            if (token_end >= resync_offset || token_is<EOFToken>(token))
+            {
+                failed = true;
+                parser.m_tokenizer.pause();
+                return;
+            }
+
+            parser.process_token(token, token_end);
+
+            if (parser.m_open_elements.size() < depth || parser.m_open_elements[depth - 1] != new_element)
+            {
+                // The element got closed before its old end tag.
+                failed = true;
+                parser.m_tokenizer.pause();
+            }
+        }, state.input_properties);
+
+        parser.m_tokenizer.restore(checkpoint.tokenizer);
+
+        parser.m_tokenizer.run_until(document.m_source.length());
+
+        if (!resynced)
+        {
+            source_ranges.resize(first_new_id);
+            return false;
+        }
+
+        // Replace the old contents, the ids of the old nodes are handed out to the new ones again.
+        std::vector<Node*> stack(element.m_child_nodes.begin(), element.m_child_nodes.end());
+
+        while (!stack.empty())
+        {
+            auto* node = stack.back();
+            stack.pop_back();
+
+            if (node->m_id != InvalidNodeId)
+            {
+                state.free_node_ids.push_back(node->m_id);
+            }
+
+            if (node->type() == NodeType::Element)
+            {
+                state.checkpoints.erase(static_cast<const Element*>(node));
+            }
+
+            stack.insert(stack.end(), node->m_child_nodes.begin(), node->m_child_nodes.end());
+        }
+
+        for (auto* child : element.m_child_nodes)
+        {
+            delete child;
+        }
+
+        element.m_child_nodes = std::move(new_element->m_child_nodes);
+        new_element->m_child_nodes.clear();
+
+        for (auto* child : element.m_child_nodes)
+        {
+            child->m_parent = &element;
+        }
+
+        // The new ranges already have the new offsets, so they're marked as having the shift of this edit applied.
+        document.m_source_shifts.push_back({ .position = edit_end, .delta = delta, .removed_length = edit_end - edit_offset });
+        const auto shifts_applied = static_cast<uint32_t>(document.m_source_shifts.size());
+
+        std::vector<DOM::Document::StoredSourceRange> new_ranges(source_ranges.begin() + static_cast<ptrdiff_t>(first_new_id), source_ranges.end());
+        source_ranges.resize(first_new_id);
+
+        stack.assign(element.m_child_nodes.begin(), element.m_child_nodes.end());
+
+        while (!stack.empty())
+        {
+            auto* node = stack.back();
+            stack.pop_back();
+
+            if (node->m_id != InvalidNodeId)
+            {
+                const auto range = new_ranges[node->m_id - first_new_id].range;
+
+                if (state.free_node_ids.empty())
+                {
+                    node->m_id = static_cast<uint32_t>(source_ranges.size());
+                    source_ranges.emplace_back();
+                }
+                else
+                {
+                    node->m_id = state.free_node_ids.back();
+                    state.free_node_ids.pop_back();
+                }
+
+                source_ranges[node->m_id] = { .range = range, .shifts_applied = shifts_applied };
+            }
+
+            stack.insert(stack.end(), node->m_child_nodes.begin(), node->m_child_nodes.end());
+        }
+
+        for (auto& [_, new_checkpoint] : new_checkpoints)
+        {
+            new_checkpoint.shifts_applied = shifts_applied;
+        }
+
+        // NOTE: The element's contents still start where they did, even if the edit inserted text right there.
+        checkpoint_it->second.tokenizer.offset = checkpoint.tokenizer.offset;
+        checkpoint_it->second.shifts_applied = shifts_applied;
+
+        // NOTE: The stand-in took the new contents without ever being popped, so the style block is updated here.
+        if (auto* style = dynamic_cast<HTMLStyleElement*>(&element); style)
+        {
+            style->update_style_block();
+        }
+
+        state.checkpoints.merge(new_checkpoints);
+
+        if (document.m_source_shifts.size() >= MaxPendingSourceShifts)
+        {
+            apply_source_shifts(document);
+        }
+
+        return true;
+    }
+
+    auto Parser::reparse_document(Document& document) -> Node*
+    {
+        const auto source = std::move(document.m_source);
+
+        Parser parser;
+        auto parsed = std::unique_ptr<Document>(parser.parse(source, { .incremental = true }));
+
+        for (auto* child : document.m_child_nodes)
+        {
+            delete child;
+        }
+
+        document.m_child_nodes = std::move(parsed->m_child_nodes);
+        parsed->m_child_nodes.clear();
+
+        std::vector<Node*> stack(document.m_child_nodes.begin(), document.m_child_nodes.end());
+
+        for (auto* child : document.m_child_nodes)
+        {
+            child->m_parent = &document;
+        }
+
+        while (!stack.empty())
+        {
+            auto* node = stack.back();
+            stack.pop_back();
+
+            node->m_document = &document;
+            stack.insert(stack.end(), node->m_child_nodes.begin(), node->m_child_nodes.end());
+        }
+
+        document.m_head = parsed->m_head;
+        document.m_body = parsed->m_body;
+        document.m_source = std::move(parsed->m_source);
+        document.m_source_ranges = std::move(parsed->m_source_ranges);
+        document.m_source_shifts.clear();
+        document.m_line_index.reset();
+        document.m_incremental_state = std::move(parsed->m_incremental_state);
+
+        return &document;
+    }
+
+    void Parser::apply_source_shifts(Document& document)
+    {
+        const auto& shifts = document.m_source_shifts;
+
+        // The logged shifts composed into one, i.e. by how much offsets from before any of them moved, starting at
+        // which offset. Most offsets haven't had any of the shifts applied yet, they take a binary search this way
+        // rather than a step per shift.
+        struct ComposedShift
+        {
+            size_t position = 0;
+            ptrdiff_t delta = 0;
+        };
+
+        std::vector<ComposedShift> composed;
+        composed.reserve(shifts.size());
+
+        for (size_t i = 0; i < shifts.size(); ++i)
+        {
+            // The smallest offset the shifts before this one move to its position or past it.
+            auto position = shifts[i].position;
+
+            for (size_t j = i; j-- > 0;)
+            {
+                const auto& shift = shifts[j];
+                const auto removed_begin = shift.position - shift.removed_length;
+                const auto inserted_end = static_cast<size_t>(static_cast<ptrdiff_t>(shift.position) + shift.delta);
+
+                if (position <= removed_begin)
+                {
+                    continue;
+                }
+
+                // Offsets within the inserted text weren't anywhere before the edit, the first one after it was.
+                position = position >= inserted_end ? static_cast<size_t>(static_cast<ptrdiff_t>(position) - shift.delta) : shift.position;
+            }
+
+            composed.push_back({ .position = position, .delta = shifts[i].delta });
+        }
+
+        std::ranges::sort(composed, {}, &ComposedShift::position);
+
+        for (size_t i = 1; i < composed.size(); ++i)
+        {
+            composed[i].delta += composed[i - 1].delta;
+        }
+
+        const auto shifted = [&](size_t offset, uint32_t shifts_applied)
+        {
+            if (shifts_applied != 0)
+            {
+                return document.shifted_source_offset(offset, shifts_applied);
+            }
+
+            const auto it = std::ranges::upper_bound(composed, offset, {}, &ComposedShift::position);
+            return it == composed.begin() ? offset : static_cast<size_t>(static_cast<ptrdiff_t>(offset) + std::prev(it)->delta);
+        };
+
+        for (auto& stored : document.m_source_ranges)
+        {
+            stored.range.begin = shifted(stored.range.begin, stored.shifts_applied);
+            stored.range.end = shifted(stored.range.end, stored.shifts_applied);
+            stored.shifts_applied = 0;
+        }
+
+        for (auto& [_, checkpoint] : document.m_incremental_state->checkpoints)
+        {
+            checkpoint.tokenizer.offset = shifted(checkpoint.tokenizer.offset, checkpoint.shifts_applied);
+            checkpoint.shifts_applied = 0;
+        }
+
+        document.m_source_shifts.clear();
+    }
+
+}
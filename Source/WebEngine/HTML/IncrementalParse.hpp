@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Parser.hpp"
+
+namespace Hanami::HTML {
+
+    // Parser state right after an element's start tag, which is enough to re-parse the element's contents on their own.
+    struct ElementCheckpoint
+    {
+        // Its offset is where the element's contents begin.
+        Tokenizer::Checkpoint tokenizer;
+        TreeInsertionMode insertion_mode;
+        TreeInsertionMode original_insertion_mode;
+
+        // Insertion mode the element's own end tag was processed in, unset if the element was closed implicitly
+        // (or not at all). Only elements with an end tag have a point where a re-parse can resync with the old tree.
+        std::optional<TreeInsertionMode> end_tag_insertion_mode;
+
+        // How many of the document's logged source shifts the tokenizer offset has applied, see Document::source_range().
+        uint32_t shifts_applied = 0;
+    };
+
+    // Kept by documents parsed with ParseOptions::incremental, see Document::reparse_range().
+    struct IncrementalParseState
+    {
+        ElementCheckpoints checkpoints;
+
+        // What the source is known to contain, kept up to date with every edit so re-parses run the same
+        // specialization of the tokenizer as the original parse.
+        Tokenizer::InputProperties input_properties{};
+
+        // Ids of nodes replaced by re-parses, handed out to the nodes replacing them before any new ids are.
+        std::vector<uint32_t> free_node_ids{};
+    };
+
+}
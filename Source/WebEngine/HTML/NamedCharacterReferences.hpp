@@ -1,13 +1,22 @@
 #pragma once
 
+#include <optional>
+#include <algorithm>
 #include <string_view>
-#include <unordered_map>
 
 namespace Hanami::HTML {
 
+    struct NamedCharacterReference
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
     // https://html.spec.whatwg.org/multipage/named-characters.html#named-character-references
 
-    inline static auto named_character_references = std::unordered_map<std::string_view, std::string_view>({
+    // NOTE: Sorted by name so lookups can binary search. Being constexpr, the table is constant-initialized and involves
+    //       no dynamic initialization (or destruction) of a global.
+    inline constexpr NamedCharacterReference named_character_references[] = {
         { "&AElig", "\u{c6}" },
         { "&AElig;", "\u{c6}" },
         { "&AMP", "\u{26}" },
@@ -2239,6 +2248,27 @@ namespace Hanami::HTML {
         { "&zscr;", "\u{1d4cf}" },
         { "&zwj;", "\u{200d}" },
         { "&zwnj;", "\u{200c}" },
-    });
+    };
+
+    static_assert(std::ranges::is_sorted(named_character_references, {}, &NamedCharacterReference::name));
+
+    inline auto find_named_character_reference(std::string_view name) -> std::optional<std::string_view>
+    {
+        const auto* it = std::ranges::lower_bound(named_character_references, name, {}, &NamedCharacterReference::name);
+
+        if (it == std::ranges::end(named_character_references) || it->name != name)
+        {
+            return std::nullopt;
+        }
+
+        return it->value;
+    }
+
+    // Returns whether any named character reference starts with prefix, i.e. whether consuming more characters can still produce a match.
+    inline auto is_named_character_reference_prefix(std::string_view prefix) -> bool
+    {
+        const auto* it = std::ranges::lower_bound(named_character_references, prefix, {}, &NamedCharacterReference::name);
+        return it != std::ranges::end(named_character_references) && it->name.starts_with(prefix);
+    }
 
 }
@@ -0,0 +1,41 @@
+#include "ParseError.hpp"
+
+namespace Hanami::HTML {
+
+    auto parse_error_code(ErrorType type) noexcept -> std::string_view
+    {
+        switch (type)
+        {
+            case ErrorType::AbruptClosingOfEmptyComment: return "abrupt-closing-of-empty-comment";
+            case ErrorType::AbsenceOfDigitsInNumericCharacterReference: return "absence-of-digits-in-numeric-character-reference";
+            case ErrorType::CDATAInHTMLContent: return "cdata-in-html-content";
+            case ErrorType::CharacterReferenceOutsideUnicodeRange: return "character-reference-outside-unicode-range";
+            case ErrorType::ControlCharacterReference: return "control-character-reference";
+            case ErrorType::EOFBeforeTagName: return "eof-before-tag-name";
+            case ErrorType::EOFInCDATA: return "eof-in-cdata";
+            case ErrorType::EOFInComment: return "eof-in-comment";
+            case ErrorType::EOFInDOCTYPE: return "eof-in-doctype";
+            case ErrorType::EOFInTag: return "eof-in-tag";
+            case ErrorType::IncorrectlyOpenedComment: return "incorrectly-opened-comment";
+            case ErrorType::InvalidFirstCharacterOfTagName: return "invalid-first-character-of-tag-name";
+            case ErrorType::MissingAttributeValue: return "missing-attribute-value";
+            case ErrorType::MissingDOCTYPEName: return "missing-doctype-name";
+            case ErrorType::MissingEndTagName: return "missing-end-tag-name";
+            case ErrorType::MissingSemicolonAfterCharacterReference: return "missing-semicolon-after-character-reference";
+            case ErrorType::MissingWhitespaceBeforeDOCTYPEName: return "missing-whitespace-before-doctype-name";
+            case ErrorType::MissingWhitespaceBetweenAttributes: return "missing-whitespace-between-attributes";
+            case ErrorType::NonCharacterCharacterReference: return "noncharacter-character-reference";
+            case ErrorType::NullCharacterReference: return "null-character-reference";
+            case ErrorType::SurrogateCharacterReference: return "surrogate-character-reference";
+            case ErrorType::UnexpectedCharacterInAttributeName: return "unexpected-character-in-attribute-name";
+            case ErrorType::UnexpectedCharacterInUnquotedAttributeValue: return "unexpected-character-in-unquoted-attribute-value";
+            case ErrorType::UnexpectedEqualsSignBeforeAttributeName: return "unexpected-equals-sign-before-attribute-name";
+            case ErrorType::UnexpectedNullCharacter: return "unexpected-null-character";
+            case ErrorType::UnexpectedQuestionMarkInsteadOfTagName: return "unexpected-question-mark-instead-of-tag-name";
+            case ErrorType::UnexpectedSolidusInTag: return "unexpected-solidus-in-tag";
+        }
+
+        return "unknown";
+    }
+
+}
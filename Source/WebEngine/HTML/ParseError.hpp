@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Hanami::HTML {
+
+    // https://html.spec.whatwg.org/multipage/parsing.html#parse-errors
+    enum class ErrorType : uint8_t
+    {
+        AbruptClosingOfEmptyComment,
+        AbsenceOfDigitsInNumericCharacterReference,
+        CDATAInHTMLContent,
+        CharacterReferenceOutsideUnicodeRange,
+        ControlCharacterReference,
+        EOFBeforeTagName,
+        EOFInCDATA,
+        EOFInComment,
+        EOFInDOCTYPE,
+        EOFInTag,
+        IncorrectlyOpenedComment,
+        InvalidFirstCharacterOfTagName,
+        MissingAttributeValue,
+        MissingDOCTYPEName,
+        MissingEndTagName,
+        MissingSemicolonAfterCharacterReference,
+        MissingWhitespaceBeforeDOCTYPEName,
+        MissingWhitespaceBetweenAttributes,
+        NonCharacterCharacterReference,
+        NullCharacterReference,
+        SurrogateCharacterReference,
+        UnexpectedCharacterInAttributeName,
+        UnexpectedCharacterInUnquotedAttributeValue,
+        UnexpectedEqualsSignBeforeAttributeName,
+        UnexpectedNullCharacter,
+        UnexpectedQuestionMarkInsteadOfTagName,
+        UnexpectedSolidusInTag,
+    };
+
+    struct ParseError
+    {
+        ErrorType type;
+
+        // Offset of the input character the tokenizer was looking at, in the input after newline normalization.
+        size_t offset;
+    };
+
+    // The error code used by the spec, e.g. "eof-in-tag".
+    [[nodiscard]]
+    auto parse_error_code(ErrorType type) noexcept -> std::string_view;
+
+}
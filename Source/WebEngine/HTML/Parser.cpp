@@ -1,4 +1,7 @@
 #include "Parser.hpp"
+#include "PreloadScanner.hpp"
+#include "IncrementalParse.hpp"
+#include "SpeculativeTokenizer.hpp"
 
 #include "WebEngine/DOM/Text.hpp"
 #include "WebEngine/DOM/Comment.hpp"
@@ -6,10 +9,15 @@
 #include "WebEngine/DOM/HTMLElement.hpp"
 #include "WebEngine/DOM/CharacterData.hpp"
 
+#include "WebEngine/CSS/Parser.hpp"
+
+#include "WebEngine/Core/RingBuffer.hpp"
+#include "WebEngine/Core/ThreadPool.hpp"
+
 #include "Kori/Core.hpp"
 
 #include <print>
-#include <regex>
+#include <thread>
 #include <csignal>
 #include <algorithm>
 #include <fstream>
@@ -27,21 +35,254 @@ namespace Hanami::HTML {
     Parser::Parser() noexcept
         : m_document(std::make_unique<Document>())
     {
+        m_tokenizer.set_foreign_content_func([this]
+        {
+            return !m_open_elements.empty() && !adjusted_current_node()->is_in_namespace(html_namespace);
+        });
     }
 
-    auto Parser::parse(std::string_view html) -> Document*
+    auto Parser::parse(std::string_view html, const ParseOptions& options) -> Document*
     {
-        m_input_stream = normalize_input_stream(html);
+        // NOTE: A parser can be reused for several documents, every parse hands its input stream over to the document.
+        if (!m_document)
+        {
+            m_document = std::make_unique<Document>();
+        }
 
-        m_tokenizer.start(m_input_stream, [&](const Token& token)
+        m_original_insertion_mode = TreeInsertionMode::Initial;
+        m_insertion_mode = TreeInsertionMode::Initial;
+        m_open_elements.clear();
+        m_frameset_ok = FramesetOK::Ok;
+
+        normalize_input_stream(html, m_input_stream);
+        m_input_properties = options.specialize_tokenizer ? Tokenizer::scan_input(m_input_stream) : Tokenizer::InputProperties{};
+
+        std::optional<PreloadScanner> preload_scanner;
+
+        if (options.preload_queue)
         {
-            process_token(token);
-        });
+            preload_scanner.emplace(m_input_stream, *options.preload_queue);
+        }
+
+        const auto tokenizer_threads = options.tokenizer_threads != 0 ? options.tokenizer_threads : std::thread::hardware_concurrency();
+
+        m_token_range = {};
+        m_tokenizer.set_parse_errors(options.parse_errors);
+
+        if (options.incremental)
+        {
+            auto state = std::make_unique<IncrementalParseState>();
+            state->input_properties = m_input_properties;
+
+            m_element_checkpoints = &state->checkpoints;
+            KoriDefer { m_element_checkpoints = nullptr; };
+
+            m_tokenizer.start(m_input_stream, [&](const Token& token)
+            {
+                process_token(token, m_tokenizer.current_offset());
+            }, m_input_properties);
+
+            m_document->m_incremental_state = std::move(state);
+        }
+        else if (m_input_stream.length() >= options.parallel_tokenization_threshold && tokenizer_threads > 1 && !options.parse_errors)
+        {
+            run_tokenizer_speculatively(tokenizer_threads);
+        }
+        else if (options.pipelined)
+        {
+            run_tokenizer_pipelined();
+        }
+        else
+        {
+            m_tokenizer.start(m_input_stream, [&](const Token& token)
+            {
+                process_token(token, m_tokenizer.current_offset());
+            }, m_input_properties);
+        }
+
+        // The preload scanner reads the input stream until it's joined, only then can the document take it.
+        preload_scanner.reset();
+        m_document->m_source = std::move(m_input_stream);
+        m_input_stream.clear();
 
         return m_document.release();
     }
 
-    auto Parser::parse_from_file(const std::filesystem::path& path) -> Document*
+    void Parser::run_tokenizer_pipelined()
+    {
+        // NOTE: Tokens are handed over in batches rather than one by one, otherwise the atomics (and wakeups) in the
+        //       ring buffer would cost more than tokenizing a character does. A partial batch is flushed whenever
+        //       the tokenizer has to sync with us.
+        static constexpr size_t BatchSize = 256;
+
+        struct PositionedToken
+        {
+            Token token;
+            size_t end_offset;
+        };
+
+        using TokenBatch = std::vector<PositionedToken>;
+        auto ring = std::make_unique<SPSCRingBuffer<TokenBatch, 64>>();
+        TokenBatch* batch = nullptr;
+
+        auto flush_batch = [&]
+        {
+            if (batch)
+            {
+                ring->end_write();
+                batch = nullptr;
+            }
+        };
+
+        // Whenever the tokenizer needs state owned by the tree builder (e.g. a <title> start tag switching it to RCDATA)
+        // it hands everything over and blocks until we've caught up. Only a handful of tags do this, so the two threads
+        // only run in lock-step for those.
+        m_tokenizer.set_sync_func([&]
+        {
+            flush_batch();
+            ring->wait_until_drained();
+        });
+
+        KoriDefer { m_tokenizer.set_sync_func({}); };
+
+        std::jthread tokenizer_thread([&]
+        {
+            m_tokenizer.start(m_input_stream, [&](const Token& token)
+            {
+                if (!batch)
+                {
+                    batch = &ring->begin_write();
+                    batch->clear();
+                }
+
+                batch->emplace_back(token, m_tokenizer.current_offset());
+
+                if (batch->size() == BatchSize || token_is<EOFToken>(token))
+                {
+                    flush_batch();
+                }
+            }, m_input_properties);
+
+            flush_batch();
+        });
+
+        bool reached_eof = false;
+
+        while (!reached_eof)
+        {
+            const auto& tokens = ring->begin_read();
+
+            for (const auto& [token, end_offset] : tokens)
+            {
+                process_token(token, end_offset);
+                reached_eof |= token_is<EOFToken>(token);
+            }
+
+            ring->end_read();
+        }
+    }
+
+    void Parser::run_tokenizer_speculatively(uint32_t thread_count)
+    {
+        ThreadPool pool(thread_count);
+
+        const auto split_points = find_speculative_split_points(m_input_stream, pool.thread_count());
+        const auto chunks = tokenize_speculatively(m_input_stream, split_points, pool, m_input_properties);
+
+        // Everything before position has been handed to the tree builder, and the real tokenizer is in the data state there.
+        size_t position = 0;
+        bool reached_eof = false;
+
+        // Continues with the real tokenizer from checkpoint until it's back in the data state at or past offset.
+        auto tokenize_sequentially = [&](const Tokenizer::Checkpoint& checkpoint, size_t offset)
+        {
+            m_tokenizer.reset(m_input_stream, [&](const Token& token)
+            {
+                process_token(token, m_tokenizer.current_offset());
+            }, m_input_properties);
+
+            m_tokenizer.restore(checkpoint);
+
+            reached_eof = m_tokenizer.run_until(offset);
+            position = m_tokenizer.current_offset();
+        };
+
+        for (const auto& chunk : chunks)
+        {
+            if (reached_eof)
+            {
+                break;
+            }
+
+            // Already covered by re-tokenizing an earlier chunk.
+            if (position >= chunk.end)
+            {
+                continue;
+            }
+
+            // The previous chunk ended somewhere other than where this one assumed it would start (e.g. inside a comment),
+            // so none of its tokens can be trusted.
+            if (position != chunk.begin)
+            {
+                tokenize_sequentially({ .offset = position }, chunk.end);
+                continue;
+            }
+
+            size_t replayed_characters = 0;
+            bool guessed_wrong = false;
+
+            // NOTE: Only the end of a run of characters is known, which is all the source range of a text node needs.
+            auto replay_characters = [&](size_t count, size_t end_offset)
+            {
+                for (; replayed_characters < count; ++replayed_characters)
+                {
+                    process_token(CharacterToken{ chunk.characters[replayed_characters] }, end_offset);
+                }
+            };
+
+            m_tokenizer.set_state(Tokenizer::State::Data);
+
+            for (const auto& [characters_before, begin_offset, end_offset, token] : chunk.markup)
+            {
+                replay_characters(characters_before, begin_offset);
+                process_token(token, end_offset);
+                position = end_offset;
+
+                if (token_is<EOFToken>(token))
+                {
+                    reached_eof = true;
+                    break;
+                }
+
+                // The tree builder switched the tokenizer out of the data state (e.g. for <title>),
+                // everything after this token was tokenized under the wrong assumption.
+                if (m_tokenizer.state() != Tokenizer::State::Data)
+                {
+                    tokenize_sequentially({
+                        .offset = position,
+                        .state = m_tokenizer.state(),
+                        .last_start_tag_name = std::string{ token_tag_name(token) },
+                    }, chunk.end);
+                    guessed_wrong = true;
+                    break;
+                }
+            }
+
+            if (!guessed_wrong && !reached_eof)
+            {
+                replay_characters(chunk.characters.length(), chunk.stop);
+                position = chunk.stop;
+
+                // The chunk stopped early, e.g. at a CDATA section.
+                if (position < chunk.end)
+                {
+                    tokenize_sequentially({ .offset = position }, chunk.end);
+                }
+            }
+        }
+    }
+
+    auto Parser::parse_from_file(const std::filesystem::path& path, const ParseOptions& options) -> Document*
     {
         std::stringstream ss;
         std::ifstream stream(path);
@@ -54,15 +295,70 @@ namespace Hanami::HTML {
 
         ss << stream.rdbuf();
 
-        return Parser{}.parse(ss.str());
+        return Parser{}.parse(ss.str(), options);
     }
 
     // https://infra.spec.whatwg.org/#normalize-newlines
-    auto Parser::normalize_input_stream(std::string_view in) noexcept -> std::string
+    void Parser::normalize_input_stream(std::string_view in, std::string& out)
     {
-        auto str = std::regex_replace(std::string{ in }, std::regex("\r\n"), "\n");
-        std::ranges::replace(str, '\r', '\n');
-        return str;
+        out.clear();
+        out.reserve(in.length());
+
+        size_t pos = 0;
+
+        while (pos < in.length())
+        {
+            const auto cr = in.find('\r', pos);
+
+            if (cr == std::string_view::npos)
+            {
+                out.append(in.substr(pos));
+                break;
+            }
+
+            // Replace every U+000D CR U+000A LF code point pair with a single U+000A LF code point,
+            // and then replace every remaining U+000D CR code point with a U+000A LF code point.
+            out.append(in.substr(pos, cr - pos));
+            out += '\n';
+            pos = cr + 1;
+
+            if (pos < in.length() && in[pos] == '\n')
+            {
+                ++pos;
+            }
+        }
+    }
+
+    void Parser::process_token(const Token& token, size_t end_offset)
+    {
+        // NOTE: Tokens cover the input without gaps, so every token starts where the previous one ended.
+        m_token_range = { m_token_range.end, end_offset };
+
+        const auto* end_tag = std::get_if<EndTagToken>(&token);
+        m_end_tag_name = end_tag ? std::string_view{ end_tag->name } : std::string_view{};
+
+        if (!m_element_checkpoints)
+        {
+            process_token(token);
+            return;
+        }
+
+        m_insertion_mode_before_token = m_insertion_mode;
+        m_last_inserted_element = nullptr;
+
+        process_token(token);
+
+        // Checkpoint elements whose contents start right after this token. Void elements have been popped already,
+        // and elements inserted as a side effect of the token (e.g. an implied tbody) aren't current anymore.
+        if (m_last_inserted_element && m_last_inserted_element == current_node() && token_is<StartTagToken>(token))
+        {
+            m_element_checkpoints->insert_or_assign(m_last_inserted_element, ElementCheckpoint {
+                .tokenizer = m_tokenizer.checkpoint(),
+                .insertion_mode = m_insertion_mode,
+                .original_insertion_mode = m_original_insertion_mode,
+                .end_tag_insertion_mode = std::nullopt,
+            });
+        }
     }
 
     // https://html.spec.whatwg.org/multipage/parsing.html#tree-construction
@@ -141,10 +437,13 @@ namespace Hanami::HTML {
                             // its public ID set to the public identifier given in the DOCTYPE token, or the empty string if the public identifier was missing;
                             // and its system ID set to the system identifier given in the DOCTYPE token, or the empty string if the system identifier was missing.
 
-                            m_document->append_child(new DocumentType(
+                            auto* doctype = new DocumentType(
                                 d->name,
                                 d->public_identifier.value_or(""),
-                                d->system_identifier.value_or("")));
+                                d->system_identifier.value_or(""));
+
+                            track_source_range(doctype);
+                            m_document->append_child(doctype);
 
                             // TODO: If this becomes relevant
                             // Then, if the document is not an iframe srcdoc document,
@@ -383,7 +682,7 @@ namespace Hanami::HTML {
                                 // Insert an HTML element for the token. Immediately pop the current node off the stack of open elements.
                                 insert_html_element(token);
 
-                                m_open_elements.pop_back();
+                                pop_current_node();
 
                                 // Acknowledge the token's self-closing flag, if it is set.
                                 if (t->self_closing)
@@ -423,9 +722,8 @@ namespace Hanami::HTML {
                                 (t->name == "noframes" || t->name == "style")
                             )
                             {
-                                // TODO(Peter):
                                 // Follow the generic raw text element parsing algorithm.
-                                NOT_IMPLEMENTED();
+                                parse_generic_raw_text_element(*t);
                                 break;
                             }
 
@@ -459,7 +757,7 @@ namespace Hanami::HTML {
                             if (t->name == "head")
                             {
                                 // Pop the current node (which will be the head element) off the stack of open elements.
-                                m_open_elements.pop_back();
+                                pop_current_node();
 
                                 // Switch the insertion mode to "after head".
                                 m_insertion_mode = TreeInsertionMode::AfterHead;
@@ -472,7 +770,7 @@ namespace Hanami::HTML {
                                 // Act as described in the "anything else" entry below.
 
                                 // Pop the current node (which will be the head element) off the stack of open elements.
-                                m_open_elements.pop_back();
+                                pop_current_node();
 
                                 // Switch the insertion mode to "after head".
                                 m_insertion_mode = TreeInsertionMode::AfterHead;
@@ -499,7 +797,7 @@ namespace Hanami::HTML {
 
                         // Anything else
                         // Pop the current node (which will be the head element) off the stack of open elements.
-                        m_open_elements.pop_back();
+                        pop_current_node();
 
                         // Switch the insertion mode to "after head".
                         m_insertion_mode = TreeInsertionMode::AfterHead;
@@ -527,7 +825,7 @@ namespace Hanami::HTML {
                             // Parse error.
                             // If the current node is a script element, then set its already started to true.
                             // Pop the current node off the stack of open elements.
-                            m_open_elements.pop_back();
+                            pop_current_node();
 
                             // Switch the insertion mode to the original insertion mode and reprocess the token.
                             m_insertion_mode = m_original_insertion_mode;
@@ -576,7 +874,7 @@ namespace Hanami::HTML {
 
                             // Any other end tag
                             // Pop the current node off the stack of open elements.
-                            m_open_elements.pop_back();
+                            pop_current_node();
 
                             // Switch the insertion mode to the original insertion mode.
                             m_insertion_mode = m_original_insertion_mode;
@@ -950,7 +1248,7 @@ namespace Hanami::HTML {
                             // Generate implied end tags.
                             while (current_node_is_any_of({ "dd", "dt", "li", "optgroup", "option", "p", "rb", "rp", "rt", "rtc" }))
                             {
-                                m_open_elements.pop_back();
+                                pop_current_node();
                             }
 
                             // If the current node is not an HTML element with the same tag name as that of the token, then this is a parse error.
@@ -962,7 +1260,7 @@ namespace Hanami::HTML {
                             // Pop elements from the stack of open elements until an HTML element with the same tag name as the token has been popped from the stack.
                             while (auto* current = current_node())
                             {
-                                m_open_elements.pop_back();
+                                pop_current_node();
 
                                 if (current->local_name == token_tag_name(token))
                                 {
@@ -1120,7 +1418,7 @@ namespace Hanami::HTML {
                             insert_html_element(token);
 
                             // Immediately pop the current node off the stack of open elements.
-                            m_open_elements.pop_back();
+                            pop_current_node();
 
                             // Acknowledge the token's self-closing flag, if it is set.
                             // Set the frameset-ok flag to "not ok".
@@ -1137,7 +1435,7 @@ namespace Hanami::HTML {
                             insert_html_element(token);
 
                             // Immediately pop the current node off the stack of open elements.
-                            m_open_elements.pop_back();
+                            pop_current_node();
 
                             // Acknowledge the token's self-closing flag, if it is set.
                             // If the token does not have an attribute with the name "type", or if it does, but that attribute's value is not an ASCII case-insensitive match for the string "hidden"
@@ -1418,7 +1716,10 @@ namespace Hanami::HTML {
         // Set the insertion point to undefined.
         // Update the current document readiness to "interactive".
         // Pop all the nodes off the stack of open elements.
-        m_open_elements.clear();
+        while (!m_open_elements.empty())
+        {
+            pop_current_node();
+        }
 
         // While the list of scripts that will execute when the document has finished parsing is not empty:
         // Spin the event loop until the first script in the list of scripts that will execute when the document has finished parsing has its ready to be parser-executed set to true and the parser's Document has no style sheet that is blocking scripts.
@@ -1470,6 +1771,51 @@ namespace Hanami::HTML {
         return m_open_elements.back();
     }
 
+    auto Parser::track_source_range(Node* node) -> SourceRange&
+    {
+        auto& ranges = m_document->m_source_ranges;
+
+        if (node->m_id == InvalidNodeId)
+        {
+            node->m_id = static_cast<uint32_t>(ranges.size());
+            ranges.push_back({ .range = m_token_range, .shifts_applied = static_cast<uint32_t>(m_document->m_source_shifts.size()) });
+        }
+
+        return ranges[node->m_id].range;
+    }
+
+    void Parser::pop_current_node()
+    {
+        auto* element = m_open_elements.back();
+
+        // An element popped by its own end tag ends with that tag, one that is closed implicitly ends where the token closing it starts.
+        if (element->local_name == m_end_tag_name)
+        {
+            track_source_range(element).end = m_token_range.end;
+
+            if (m_element_checkpoints)
+            {
+                if (auto it = m_element_checkpoints->find(element); it != m_element_checkpoints->end())
+                {
+                    it->second.end_tag_insertion_mode = m_insertion_mode_before_token;
+                }
+            }
+        }
+        else
+        {
+            track_source_range(element).end = m_token_range.begin;
+        }
+
+        m_open_elements.pop_back();
+
+        // https://html.spec.whatwg.org/multipage/semantics.html#update-a-style-block
+        // The user agent must run the update a style block algorithm whenever [...] the element is popped off the stack of open elements of an HTML parser or XML parser.
+        if (auto* style = dynamic_cast<HTMLStyleElement*>(element); style)
+        {
+            style->update_style_block();
+        }
+    }
+
     auto Parser::adjusted_current_node() const noexcept -> Element*
     {
         // The adjusted current node is the context element if the parser was created as
@@ -1539,6 +1885,9 @@ namespace Hanami::HTML {
         if (auto* t = dynamic_cast<Text*>(*(adjusted_insertion_location--)); t)
         {
             t->m_data += data;
+            t->set_needs_layout();
+            ++m_document->m_version;
+            track_source_range(t).end = m_token_range.end;
         }
         else
         {
@@ -1547,6 +1896,7 @@ namespace Hanami::HTML {
             // and insert the newly created node at the adjusted insertion location.
             auto* text = new Text(data);
             text->m_document = current_node()->m_document;
+            track_source_range(text);
             current_node()->insert_before(text, *adjusted_insertion_location);
         }
     }
@@ -1561,6 +1911,7 @@ namespace Hanami::HTML {
         // Create a Comment node whose data attribute is set to data
         // and whose node document is the same as that of the node in which the adjusted insertion location finds itself.
         auto comment = new Comment(data);
+        track_source_range(comment);
 
         // Insert the newly created node at the adjusted insertion location.
         adjusted_insertion_location.owner->insert_before(comment, *adjusted_insertion_location);
@@ -1611,6 +1962,7 @@ namespace Hanami::HTML {
 
         // 4. Push element onto the stack of open elements so that it is the new current node.
         m_open_elements.emplace_back(element);
+        m_last_inserted_element = element;
 
         // 5. Return element.
         return element;
@@ -1626,7 +1978,8 @@ namespace Hanami::HTML {
             [](auto&&) { HANAMI_TRAP(); }
         }, token);
 
-        // TODO(Peter): Speculative parser
+        // NOTE: The speculative fetches below are currently covered by the PreloadScanner, which scans the whole input ahead
+        //       of us instead of being started whenever a parsing-blocking script is pending.
         // If the active speculative HTML parser is not null, then return the result of creating a speculative mock element given namespace, token's tag name, and token's attributes.
         // Otherwise, optionally create a speculative mock element given namespace, token's tag name, and token's attributes.
         // The result is not used. This step allows for a speculative fetch to be initiated from non-speculative parsing. The fetch is still speculative at this point, because, for example, by the time the element is inserted, intended parent might have been removed from the document.
@@ -1660,11 +2013,24 @@ namespace Hanami::HTML {
         // Let element be the result of creating an element given document, localName, namespace, null, is, willExecuteScript, and registry.
         // This will cause custom element constructors to run, if willExecuteScript is true. However, since we incremented the throw-on-dynamic-markup-insertion counter, this cannot cause new characters to be inserted into the tokenizer, or the document to be blown away.
         auto* element = create_element(document, local_name, element_namespace, std::nullopt, is, will_execute_script);
+        track_source_range(element);
 
-        // TODO(Peter):
         // Append each attribute in the given token to element.
         // This can enqueue a custom element callback reaction for the attributeChangedCallback, which might run immediately (in the next step).
         // Even though the is attribute governs the creation of a customized built-in element, it is not present during the execution of the relevant custom element constructor; it is appended in this step, along with all other attributes.
+        element->attributes.reserve(tag_token->attributes.size());
+
+        for (const auto& attribute : tag_token->attributes)
+        {
+            element->attributes.push_back({ .local_name = attribute.name, .value = attribute.value });
+        }
+
+        // NOTE: The style attribute is parsed by its attribute change steps, which run as it's appended.
+        // https://drafts.csswg.org/cssom/#the-elementcssinlinestyle-mixin
+        if (auto style = element->get_attribute("style"); style)
+        {
+            element->inline_style = std::make_unique<CSS::DeclarationBlock>(CSS::Parser::parse_style_attribute(std::string{ *style }));
+        }
 
         // If willExecuteScript is true:
         if (will_execute_script)
@@ -1756,6 +2122,11 @@ namespace Hanami::HTML {
                 // HTMLHtmlElement
                 interface = ElementInterface::HTMLHtmlElement;
             }
+            else if (local_name == "style" && element_namespace == html_namespace)
+            {
+                // HTMLStyleElement
+                interface = ElementInterface::HTMLStyleElement;
+            }
 
             // Set result to the result of creating an element internal given document, interface, localName, namespace, prefix, "uncustomized", is, and registry.
             result = create_element_internal(document, interface, local_name, element_namespace, prefix, "uncustomized", is);
@@ -1806,6 +2177,11 @@ namespace Hanami::HTML {
                 element = new HTMLHtmlElement();
                 break;
             }
+            case ElementInterface::HTMLStyleElement:
+            {
+                element = new HTMLStyleElement();
+                break;
+            }
         }
 
         element->namespace_uri = element_namespace;
@@ -11,11 +11,17 @@ namespace Hanami::HTML {
 
     using namespace DOM;
 
+    class PreloadQueue;
+    struct ElementCheckpoint;
+    struct IncrementalParseState;
+    using ElementCheckpoints = std::unordered_map<const Element*, ElementCheckpoint>;
+
     // https://dom.spec.whatwg.org/#concept-element-interface
     enum class ElementInterface
     {
         Element,
-        HTMLHtmlElement
+        HTMLHtmlElement,
+        HTMLStyleElement
     };
 
     enum class TreeInsertionMode
@@ -45,19 +51,75 @@ namespace Hanami::HTML {
         AfterAfterFrameset,
     };
 
+    struct ParseOptions
+    {
+        // Run the tokenizer on its own thread, handing tokens over to the tree builder through a ring buffer.
+        bool pipelined = false;
+
+        // Inputs at least this large are split into chunks that are tokenized in parallel, assuming each chunk starts
+        // in the data state. Chunks are validated in order, and only the ones that guessed wrong are re-tokenized.
+        size_t parallel_tokenization_threshold = 4 * 1024 * 1024;
+
+        // Number of threads used for parallel tokenization, 0 uses one per hardware thread. Every parse that tokenizes in
+        // parallel starts a thread pool of its own, so it's off unless asked for, e.g. by a caller parsing a single
+        // large document at a time.
+        uint32_t tokenizer_threads = 1;
+
+        // If set, a preload scanner runs ahead of the tree builder on its own thread and pushes the URLs of resources
+        // referenced by the document onto this queue. The queue is closed by the time parsing finishes.
+        PreloadQueue* preload_queue = nullptr;
+
+        // Track the source range of every node and keep the source along with a checkpoint for every element, so that
+        // Document::reparse_range() can rebuild parts of the tree after an edit. Implies sequential tokenization.
+        bool incremental = false;
+
+        // If set, the tokenizer's parse errors are appended to this vector, see Tokenizer::set_parse_errors().
+        // Implies sequential (or pipelined) tokenization.
+        std::vector<ParseError>* parse_errors = nullptr;
+
+        // Scan the input for NUL characters up front, and if there are none run a tokenizer without the branches replacing them.
+        // Only worth disabling to measure the difference.
+        bool specialize_tokenizer = true;
+    };
+
     class Parser
     {
     public:
         Parser() noexcept;
 
-        auto parse(std::string_view html) -> Document*;
+        // The tokenizer callbacks refer back to the parser.
+        Parser(const Parser&) = delete;
+        auto operator=(const Parser&) -> Parser& = delete;
 
-        static auto parse_from_file(const std::filesystem::path& path) -> Document*;
+        auto parse(std::string_view html, const ParseOptions& options = {}) -> Document*;
+
+        static auto parse_from_file(const std::filesystem::path& path, const ParseOptions& options = {}) -> Document*;
+
+        // See Document::reparse_range().
+        static auto reparse_range(Document& document, const TextEdit& edit) -> Node*;
 
     private:
+        void run_tokenizer_pipelined();
+        void run_tokenizer_speculatively(uint32_t thread_count);
+
         // https://html.spec.whatwg.org/multipage/parsing.html#tree-construction
         void process_token(const Token& token);
 
+        // Processes a token that ends at end_offset in the input, i.e. starts where the previous token ended, and keeps
+        // track of the source ranges of the nodes it creates (and the element checkpoints when parsing incrementally).
+        void process_token(const Token& token, size_t end_offset);
+
+        // Assigns node an id and a source range starting with the current token if it doesn't have one yet.
+        auto track_source_range(Node* node) -> SourceRange&;
+
+        static auto try_reparse_element(Document& document, Element& element, size_t edit_offset, size_t edit_end, ptrdiff_t delta) -> bool;
+        static auto reparse_document(Document& document) -> Node*;
+
+        // Brings every source range and checkpoint up to date with the logged shifts, and clears the log.
+        static void apply_source_shifts(Document& document);
+
+        void pop_current_node();
+
         // TODO(Peter): Doesn't belong here.
         void stop_parsing();
 
@@ -98,11 +160,11 @@ namespace Hanami::HTML {
         void parse_generic_rcdata_element(const Token& token, bool generic_raw_text_parse = false);
 
     private:
-        [[nodiscard]]
-        static auto normalize_input_stream(std::string_view in) noexcept -> std::string;
+        static void normalize_input_stream(std::string_view in, std::string& out);
 
     private:
         std::string m_input_stream;
+        Tokenizer::InputProperties m_input_properties{};
         Tokenizer m_tokenizer;
         TreeInsertionMode m_original_insertion_mode = TreeInsertionMode::Initial;
         TreeInsertionMode m_insertion_mode = TreeInsertionMode::Initial;
@@ -111,6 +173,14 @@ namespace Hanami::HTML {
 
         enum class FramesetOK { Ok, NotOk };
         FramesetOK m_frameset_ok = FramesetOK::Ok;
+
+        SourceRange m_token_range{};
+        std::string_view m_end_tag_name;
+
+        // Only used when parsing incrementally.
+        ElementCheckpoints* m_element_checkpoints = nullptr;
+        TreeInsertionMode m_insertion_mode_before_token = TreeInsertionMode::Initial;
+        Element* m_last_inserted_element = nullptr;
     };
 
 }
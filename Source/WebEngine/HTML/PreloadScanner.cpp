@@ -0,0 +1,243 @@
+#include "PreloadScanner.hpp"
+
+namespace Hanami::HTML {
+
+    // The URL a display with a pixel density of 1 would pick from a srcset attribute, i.e. the candidate without a
+    // descriptor or with "1x", or else the first one. Width descriptors would need the layout, so they aren't weighed.
+    // https://html.spec.whatwg.org/multipage/images.html#parsing-a-srcset-attribute
+    static auto pick_srcset_url(std::string_view srcset) -> std::string_view
+    {
+        std::string_view first_url;
+        size_t position = 0;
+
+        while (true)
+        {
+            // Collect a sequence of code points that are ASCII whitespace or U+002C COMMA characters from input given
+            // position. If any U+002C COMMA characters were collected, that is a parse error.
+            while (position < srcset.length() && (is_ascii_whitespace(srcset[position]) || srcset[position] == ','))
+            {
+                ++position;
+            }
+
+            // If position is past the end of input, return candidates.
+            if (position >= srcset.length())
+            {
+                return first_url;
+            }
+
+            // Collect a sequence of code points that are not ASCII whitespace from input given position, and let that be url.
+            const auto url_start = position;
+
+            while (position < srcset.length() && !is_ascii_whitespace(srcset[position]))
+            {
+                ++position;
+            }
+
+            auto url = srcset.substr(url_start, position - url_start);
+            std::vector<std::string_view> descriptors;
+
+            // If url ends with U+002C (,), then remove all trailing U+002C COMMA characters from url. If this removed more
+            // than one character, that is a parse error.
+            if (url.ends_with(','))
+            {
+                while (url.ends_with(','))
+                {
+                    url.remove_suffix(1);
+                }
+            }
+            // Otherwise, tokenize the descriptors.
+            // NOTE: Descriptors end at the next comma, the spec's handling of parentheses is only for future descriptors.
+            else
+            {
+                const auto comma = srcset.find(',', position);
+                const auto end = comma != std::string_view::npos ? comma : srcset.length();
+
+                descriptors = split_on_ascii_whitespace(srcset.substr(position, end - position));
+                position = end;
+            }
+
+            if (url.empty())
+            {
+                continue;
+            }
+
+            if (descriptors.empty() || (descriptors.size() == 1 && descriptors.front() == "1x"))
+            {
+                return url;
+            }
+
+            if (first_url.empty())
+            {
+                first_url = url;
+            }
+        }
+    }
+
+    void PreloadQueue::push(PreloadRequest request)
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_requests.emplace_back(std::move(request));
+        }
+
+        m_changed.notify_one();
+    }
+
+    auto PreloadQueue::pop() -> std::optional<PreloadRequest>
+    {
+        std::unique_lock lock(m_mutex);
+        m_changed.wait(lock, [this] { return !m_requests.empty() || m_closed; });
+
+        if (m_requests.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto request = std::move(m_requests.front());
+        m_requests.pop_front();
+        return request;
+    }
+
+    auto PreloadQueue::try_pop() -> std::optional<PreloadRequest>
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (m_requests.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto request = std::move(m_requests.front());
+        m_requests.pop_front();
+        return request;
+    }
+
+    void PreloadQueue::close()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_closed = true;
+        }
+
+        m_changed.notify_all();
+    }
+
+    PreloadScanner::PreloadScanner(std::string_view input, PreloadQueue& queue)
+        : m_input(input), m_queue(queue)
+    {
+        m_thread = std::jthread([this]
+        {
+            scan();
+        });
+    }
+
+    PreloadScanner::~PreloadScanner()
+    {
+        // NOTE: Nothing else loads the resources yet, so the scan always runs to the end rather than stopping once the
+        //       tree builder has caught up with it.
+        m_thread.join();
+    }
+
+    void PreloadScanner::scan()
+    {
+        m_tokenizer.start(m_input, [this](const Token& token)
+        {
+            process_token(token);
+        });
+
+        m_queue.close();
+    }
+
+    void PreloadScanner::process_token(const Token& token)
+    {
+        const auto* start_tag = std::get_if<StartTagToken>(&token);
+
+        if (!start_tag)
+        {
+            return;
+        }
+
+        const auto& name = start_tag->name;
+
+        auto request = [&](PreloadRequest::Kind kind, std::string_view attribute)
+        {
+            if (auto url = get_token_attribute_value(start_tag, attribute); url && !url->empty())
+            {
+                m_queue.push({ kind, std::string{ *url }, m_tokenizer.current_offset() });
+            }
+        };
+
+        // NOTE: A browser that supports srcset prefers it over src.
+        auto request_srcset = [&](PreloadRequest::Kind kind)
+        {
+            const auto url = pick_srcset_url(get_token_attribute_value(start_tag, "srcset").value_or(""));
+
+            if (url.empty())
+            {
+                return false;
+            }
+
+            m_queue.push({ kind, std::string{ url }, m_tokenizer.current_offset() });
+            return true;
+        };
+
+        if (name == "img")
+        {
+            if (!request_srcset(PreloadRequest::Kind::Image))
+            {
+                request(PreloadRequest::Kind::Image, "src");
+            }
+        }
+        else if (name == "script")
+        {
+            request(PreloadRequest::Kind::Script, "src");
+        }
+        else if (name == "iframe")
+        {
+            request(PreloadRequest::Kind::Document, "src");
+        }
+        else if (name == "source")
+        {
+            // The source of a picture element has a srcset, the one of an audio or video element a src.
+            if (!request_srcset(PreloadRequest::Kind::Image))
+            {
+                request(PreloadRequest::Kind::Media, "src");
+            }
+        }
+        else if (name == "link")
+        {
+            // rel is a set of keywords, e.g. "preload stylesheet" or "shortcut icon".
+            const auto keywords = split_on_ascii_whitespace(get_token_attribute_value(start_tag, "rel").value_or(""));
+
+            auto has_keyword = [&](std::string_view keyword)
+            {
+                return std::ranges::any_of(keywords, [&](std::string_view k) { return equals_case_insensitive(k, keyword); });
+            };
+
+            if (has_keyword("stylesheet"))
+            {
+                request(PreloadRequest::Kind::Stylesheet, "href");
+            }
+            else if (has_keyword("icon"))
+            {
+                request(PreloadRequest::Kind::Image, "href");
+            }
+            else if (has_keyword("preload") || has_keyword("modulepreload"))
+            {
+                request(PreloadRequest::Kind::Other, "href");
+            }
+        }
+
+        if (name == "plaintext")
+        {
+            // Nothing after this can be markup.
+            m_tokenizer.pause();
+        }
+        else if (start_tag_may_switch_tokenizer_state(name) && name != "noscript")
+        {
+            // NOTE: RCDATA instead of RAWTEXT / script data, the contents are skipped all the same.
+            m_tokenizer.set_state(Tokenizer::State::RCDATA);
+        }
+    }
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Tokenizer.hpp"
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+
+namespace Hanami::HTML {
+
+    struct PreloadRequest
+    {
+        enum class Kind : uint8_t
+        {
+            Image,
+            Script,
+            Stylesheet,
+            Document,
+            Media,
+            Other
+        };
+
+        Kind kind;
+
+        // The URL exactly as it appears in the attribute, resolving it is up to the loader.
+        std::string url;
+
+        // Offset of the end of the tag that referenced the URL.
+        size_t offset;
+    };
+
+    // Thread-safe queue of preload requests, filled by a PreloadScanner and drained by whoever loads the resources.
+    class PreloadQueue
+    {
+    public:
+        void push(PreloadRequest request);
+
+        // Blocks until there's a request, or returns std::nullopt once the queue has been closed and drained.
+        auto pop() -> std::optional<PreloadRequest>;
+
+        // Returns std::nullopt if there's no request right now.
+        auto try_pop() -> std::optional<PreloadRequest>;
+
+        // Signals that no more requests will be pushed.
+        void close();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::deque<PreloadRequest> m_requests;
+        bool m_closed = false;
+    };
+
+    // A lightweight stand-in for the speculative HTML parser. It tokenizes the input on its own thread, ahead of the tree builder,
+    // and pushes the URLs referenced by img, script, link, iframe and source elements onto a PreloadQueue.
+    //
+    // Without a tree builder it can't know the real tokenizer state, so it switches to RCDATA itself for elements whose
+    // contents aren't markup. That's good enough for finding tags, which is all it's used for.
+    class PreloadScanner
+    {
+    public:
+        // Starts scanning right away. input must outlive the scanner.
+        PreloadScanner(std::string_view input, PreloadQueue& queue);
+
+        // Waits for the scan to finish, which closes the queue.
+        ~PreloadScanner();
+
+        PreloadScanner(const PreloadScanner&) = delete;
+        auto operator=(const PreloadScanner&) -> PreloadScanner& = delete;
+
+    private:
+        void scan();
+        void process_token(const Token& token);
+
+    private:
+        std::string_view m_input;
+        PreloadQueue& m_queue;
+        Tokenizer m_tokenizer;
+
+        std::jthread m_thread;
+    };
+
+}
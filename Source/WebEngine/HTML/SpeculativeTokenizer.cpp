@@ -0,0 +1,158 @@
+#include "SpeculativeTokenizer.hpp"
+
+#include "WebEngine/Core/ThreadPool.hpp"
+
+#include <utility>
+
+namespace Hanami::HTML {
+
+    auto find_speculative_split_points(std::string_view input, size_t count) -> std::vector<size_t>
+    {
+        // How far before a chunk boundary we start looking for a comment or raw text element that is still open at it.
+        static constexpr size_t LookbehindWindow = 16 * 1024;
+
+        // Elements whose contents aren't tokenized in the data state.
+        static constexpr std::array<std::string_view, 4> raw_text_elements = { "script", "style", "textarea", "title" };
+
+        std::vector<size_t> split_points;
+
+        if (count < 2 || input.empty())
+        {
+            return split_points;
+        }
+
+        auto starts_with_case_insensitive = [&](size_t offset, std::string_view prefix)
+        {
+            return equals_case_insensitive(input.substr(offset, prefix.length()), prefix);
+        };
+
+        // The offset right after the end of a raw text element with the given name, or npos.
+        auto find_end_tag = [&](size_t offset, std::string_view name)
+        {
+            while ((offset = input.find("</", offset)) != std::string_view::npos)
+            {
+                offset += 2;
+
+                if (starts_with_case_insensitive(offset, name))
+                {
+                    return offset + name.length();
+                }
+            }
+
+            return std::string_view::npos;
+        };
+
+        const size_t chunk_size = input.length() / count;
+        size_t previous_split_point = 0;
+
+        for (size_t i = 1; i < count; ++i)
+        {
+            const auto boundary = std::max(i * chunk_size, previous_split_point + 1);
+
+            // NOTE: Scanning forward from a bit before the boundary skips over the comments and raw text elements that
+            //       started in the window in one pass, which leaves us outside of them (as far as the window can tell)
+            //       by the time we get to the boundary. A split point is always outside of them, so we can start there.
+            auto position = std::max(boundary > LookbehindWindow ? boundary - LookbehindWindow : 0, previous_split_point);
+
+            while (true)
+            {
+                position = input.find('<', position);
+
+                if (position == std::string_view::npos || position + 1 >= input.length())
+                {
+                    return split_points;
+                }
+
+                if (input.substr(position + 1).starts_with("!--"))
+                {
+                    position = input.find("-->", position + 4);
+                    continue;
+                }
+
+                const auto raw_text_element = std::ranges::find_if(raw_text_elements, [&](std::string_view name)
+                {
+                    const auto end = position + 1 + name.length();
+                    return starts_with_case_insensitive(position + 1, name) && (end == input.length() || !is_ascii_alpha_numeric(input[end]));
+                });
+
+                if (raw_text_element != raw_text_elements.end())
+                {
+                    position = find_end_tag(position + 1 + raw_text_element->length(), *raw_text_element);
+                    continue;
+                }
+
+                const char next = input[position + 1];
+
+                if (position >= boundary && (is_ascii_alpha(next) || next == '/'))
+                {
+                    break;
+                }
+
+                ++position;
+            }
+
+            split_points.emplace_back(position);
+            previous_split_point = position;
+        }
+
+        return split_points;
+    }
+
+    auto tokenize_speculatively(
+        std::string_view input,
+        std::span<const size_t> split_points,
+        ThreadPool& pool,
+        const Tokenizer::InputProperties& input_properties) -> std::vector<SpeculativeChunk>
+    {
+        std::vector<SpeculativeChunk> chunks(split_points.size() + 1);
+
+        for (size_t i = 0; i < chunks.size(); ++i)
+        {
+            auto& chunk = chunks[i];
+            chunk.begin = i == 0 ? 0 : split_points[i - 1];
+            chunk.end = i < split_points.size() ? split_points[i] : input.length();
+
+            pool.submit([input, input_properties, &chunk]
+            {
+                chunk.characters.reserve(chunk.end - chunk.begin);
+
+                Tokenizer tokenizer;
+                size_t previous_end = chunk.begin;
+
+                tokenizer.reset(input, [&](const Token& token)
+                {
+                    const auto begin = std::exchange(previous_end, tokenizer.current_offset());
+
+                    if (const auto* character = std::get_if<CharacterToken>(&token))
+                    {
+                        chunk.characters += character->data;
+                        return;
+                    }
+
+                    chunk.markup.emplace_back(chunk.characters.length(), begin, tokenizer.current_offset(), token);
+                }, input_properties);
+
+                // Whether "<![CDATA[" starts a CDATA section depends on the tree builder, so the chunk ends right before
+                // it and leaves the rest to the real tokenizer.
+                bool reached_cdata = false;
+
+                tokenizer.set_foreign_content_func([&]
+                {
+                    reached_cdata = true;
+                    tokenizer.pause();
+                    return false;
+                });
+
+                tokenizer.restore({ .offset = chunk.begin });
+
+                chunk.reached_eof = tokenizer.run_until(chunk.end);
+                chunk.stop = reached_cdata ? previous_end : tokenizer.current_offset();
+            });
+        }
+
+        pool.wait();
+
+        return chunks;
+    }
+
+}
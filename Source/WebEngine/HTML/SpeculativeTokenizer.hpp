@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Tokenizer.hpp"
+
+namespace Hanami {
+
+    class ThreadPool;
+
+}
+
+namespace Hanami::HTML {
+
+    // The tokens of one chunk of the input, tokenized under the assumption that the chunk starts in the data state.
+    //
+    // Character tokens make up the bulk of most documents, so rather than storing them as Tokens they're kept as a
+    // plain string, and every other token records how many of those characters were emitted before it.
+    struct SpeculativeChunk
+    {
+        struct MarkupToken
+        {
+            size_t characters_before;
+
+            // Offsets of the first input character of the token, and the one right after it.
+            size_t begin_offset;
+            size_t end_offset;
+
+            Token token;
+        };
+
+        size_t begin = 0;
+        size_t end = 0;
+
+        // Where the chunk tokenizer stopped, past end if the last token crossed into the next chunk, or before end if
+        // it ran into something only the real tokenizer can tokenize.
+        size_t stop = 0;
+        bool reached_eof = false;
+
+        std::string characters;
+        std::vector<MarkupToken> markup;
+    };
+
+    // Picks up to count - 1 offsets that are likely to be in the data state between two tokens, i.e. right before a '<' that
+    // starts a tag and isn't inside a comment or an element whose contents are tokenized as raw text.
+    auto find_speculative_split_points(std::string_view input, size_t count) -> std::vector<size_t>;
+
+    // Splits input at split_points and tokenizes the chunks in parallel on pool.
+    auto tokenize_speculatively(
+        std::string_view input,
+        std::span<const size_t> split_points,
+        ThreadPool& pool,
+        const Tokenizer::InputProperties& input_properties) -> std::vector<SpeculativeChunk>;
+
+}
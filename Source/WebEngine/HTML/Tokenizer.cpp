@@ -9,10 +9,16 @@
 #include <regex>
 #include <print>
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <filesystem>
 #include <signal.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define HANAMI_HAS_SSE2 1
+#endif
+
 //#define NOT_IMPLEMENTED(...)
 
 #if !defined(NOT_IMPLEMENTED)
@@ -68,19 +74,150 @@ namespace Hanami::HTML {
     {
     }
 
-    void Tokenizer::start(std::string_view input, EmitTokenFunc func)
+    void Tokenizer::start(std::string_view input, EmitTokenFunc func, std::optional<InputProperties> properties)
+    {
+        reset(input, std::move(func), properties);
+        run_until(input.length());
+    }
+
+    auto Tokenizer::scan_input(std::string_view input) noexcept -> InputProperties
+    {
+        bool nul = false;
+        size_t i = 0;
+
+#if defined(HANAMI_HAS_SSE2)
+        auto nuls = _mm_setzero_si128();
+
+        for (; i + 16 <= input.length(); i += 16)
+        {
+            const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input.data() + i));
+            nuls = _mm_or_si128(nuls, _mm_cmpeq_epi8(bytes, _mm_setzero_si128()));
+        }
+
+        nul = _mm_movemask_epi8(nuls) != 0;
+#endif
+
+        for (; i < input.length(); ++i)
+        {
+            nul |= input[i] == '\0';
+        }
+
+        return { .contains_nul = nul };
+    }
+
+    void Tokenizer::reset(std::string_view input, EmitTokenFunc func, std::optional<InputProperties> properties)
     {
         m_emit_token = std::move(func);
         m_input_stream = input;
-        m_state = State::Data;
+        m_input_properties = properties ? *properties : scan_input(input);
+        m_reached_eof = false;
+        m_paused = false;
+
+        restore({});
+    }
 
+    auto Tokenizer::checkpoint() const -> Checkpoint
+    {
+        auto checkpoint = Checkpoint {
+            .offset = m_current_char_idx,
+            .state = m_state,
+            .return_state = m_return_state,
+            .last_start_tag_name = m_last_emitted_start_token_name,
+        };
+
+        // NOTE: Between two tokens there's nothing in progress, which is where most checkpoints are taken.
+        const bool between_tokens = m_temporary_buffer.empty() && (m_state == State::Data || m_state == State::RCDATA || m_state == State::RAWTEXT);
+
+        if (!between_tokens)
+        {
+            checkpoint.token_in_progress = std::make_shared<const Checkpoint::TokenInProgress>(
+                m_current_token,
+                m_temporary_buffer,
+                m_character_reference_code);
+        }
+
+        return checkpoint;
+    }
+
+    void Tokenizer::restore(const Checkpoint& checkpoint)
+    {
+        m_current_char_idx = checkpoint.offset;
+        m_state = checkpoint.state;
+        m_return_state = checkpoint.return_state;
+        m_last_emitted_start_token_name = checkpoint.last_start_tag_name;
+        m_current_attribute = nullptr;
+
+        if (const auto* in_progress = checkpoint.token_in_progress.get())
+        {
+            m_current_token = in_progress->current_token;
+            m_temporary_buffer = in_progress->temporary_buffer;
+            m_character_reference_code = in_progress->character_reference_code;
+
+            // The attribute being built up is always the last one of the current tag.
+            if (auto* tag = std::get_if<StartTagToken>(&m_current_token); tag && !tag->attributes.empty())
+            {
+                m_current_attribute = &tag->attributes.back();
+            }
+            else if (auto* end_tag = std::get_if<EndTagToken>(&m_current_token); end_tag && !end_tag->attributes.empty())
+            {
+                m_current_attribute = &end_tag->attributes.back();
+            }
+        }
+        else
+        {
+            m_current_token = {};
+            m_temporary_buffer.clear();
+            m_character_reference_code = 0;
+        }
+    }
+
+    auto Tokenizer::run_until(size_t offset) -> bool
+    {
+        // NOTE: Reporting errors isn't worth its own set of input specializations, validators don't need the last bit of speed.
+        if (m_parse_errors)
+        {
+            return run_states_until<TokenizerTraits<true, true>>(offset);
+        }
+
+        if (!m_input_properties.contains_nul)
+        {
+            return run_states_until<TokenizerTraits<false, false>>(offset);
+        }
+
+        return run_states_until<TokenizerTraits<false, true>>(offset);
+    }
+
+    auto Tokenizer::step() -> bool
+    {
+        // NOTE: Stepping through the input is far from the fast path already, the instantiation handling any input will do.
+        if (m_parse_errors)
+        {
+            return process_next_token<TokenizerTraits<true, true>>() == ProcessResult::Abort;
+        }
+
+        return process_next_token<TokenizerTraits<false, true>>() == ProcessResult::Abort;
+    }
+
+    template<typename Traits>
+    auto Tokenizer::run_states_until(size_t offset) -> bool
+    {
         while (true)
         {
-            // TODO(Peter): Check parser pause flag and abort if set
+            if (m_paused)
+            {
+                return false;
+            }
 
-            if (process_next_token() == ProcessResult::Abort)
+            // NOTE: Offsets before the end of the input only stop us between two tokens in the data state,
+            //       which is the only place where another tokenizer can pick up without any extra state.
+            if (m_state == State::Data && m_current_char_idx >= offset && m_current_char_idx < m_input_stream.length())
             {
-                break;
+                return false;
+            }
+
+            if (process_next_token<Traits>() == ProcessResult::Abort)
+            {
+                return true;
             }
         }
     }
@@ -102,6 +239,12 @@ namespace Hanami::HTML {
         }
 
         m_emit_token(token);
+
+        // The tree builder may switch our state in response to this token, make sure it has caught up before we continue.
+        if (const auto* start_tag = std::get_if<StartTagToken>(&token); start_tag && m_sync && start_tag_may_switch_tokenizer_state(start_tag->name))
+        {
+            m_sync();
+        }
     }
 
     auto Tokenizer::consume_multiple_chars(size_t count) noexcept -> std::string_view
@@ -182,6 +325,106 @@ namespace Hanami::HTML {
         return end_tag->name == m_last_emitted_start_token_name;
     }
 
+    static auto load_word(const char* data) noexcept -> uint64_t
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    // Packs bytes the same way load_word() reads them from the input.
+    static consteval auto pack_word(std::string_view bytes) -> uint64_t
+    {
+        std::array<char, 8> array{};
+        std::ranges::copy(bytes, array.begin());
+        return std::bit_cast<uint64_t>(array);
+    }
+
+    auto Tokenizer::try_consume_common_markup() -> bool
+    {
+        // NOTE: Finding the end of a tag relies on the first byte in memory being the least significant one.
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            return false;
+        }
+
+        // Both words have to be inside the input.
+        if (m_current_char_idx + 2 * sizeof(uint64_t) > m_input_stream.length())
+        {
+            return false;
+        }
+
+        const auto* input = m_input_stream.data() + m_current_char_idx;
+        const auto word = load_word(input);
+
+        if (input[0] == '!')
+        {
+            // ASCII case-insensitive "DOCTYPE" followed by a single space and the name "html", which the states
+            // would have lowercased as well.
+            static constexpr auto DOCTYPEFold = pack_word("\x00\x20\x20\x20\x20\x20\x20\x20"sv);
+            static constexpr auto NameMask = pack_word("\xFF\xFF\xFF\xFF\xFF\xFF"sv);
+            static constexpr auto NameFold = pack_word("\x00\x20\x20\x20\x20\x00"sv);
+
+            if ((word | DOCTYPEFold) != pack_word("!doctype"sv) ||
+                ((load_word(input + 8) & NameMask) | NameFold) != pack_word(" html>"sv))
+            {
+                return false;
+            }
+
+            m_current_char_idx += 14;
+            emit_token(DOCTYPEToken{ .name = "html" });
+            return true;
+        }
+
+        const bool end_tag = input[0] == '/';
+        const size_t name_start = end_tag ? 1 : 0;
+
+        // Find the first '>' in the word, setting the high bit of every byte that is one.
+        // Bytes after the first match can be false positives, which doesn't matter here.
+        static constexpr auto Ones = pack_word("\x01\x01\x01\x01\x01\x01\x01\x01"sv);
+        static constexpr auto HighBits = pack_word("\x80\x80\x80\x80\x80\x80\x80\x80"sv);
+        static constexpr auto GreaterThanSigns = pack_word(">>>>>>>>"sv);
+
+        const auto x = word ^ GreaterThanSigns;
+        const auto matches = (x - Ones) & ~x & HighBits;
+
+        if (matches == 0)
+        {
+            return false;
+        }
+
+        const auto name_end = static_cast<size_t>(std::countr_zero(matches)) / 8;
+
+        if (name_end <= name_start || !is_ascii_lower_alpha(input[name_start]))
+        {
+            return false;
+        }
+
+        // Anything other than lowercase letters and digits (attributes, whitespace, uppercase letters, a solidus)
+        // is left to the states.
+        for (size_t i = name_start + 1; i < name_end; ++i)
+        {
+            if (!is_ascii_lower_alpha(input[i]) && !is_ascii_digit(input[i]))
+            {
+                return false;
+            }
+        }
+
+        const auto name = std::string{ input + name_start, input + name_end };
+        m_current_char_idx += name_end + 1;
+
+        if (end_tag)
+        {
+            emit_token(EndTagToken{ { .name = name } });
+        }
+        else
+        {
+            emit_token(StartTagToken{ { .name = name } });
+        }
+
+        return true;
+    }
+
     // https://html.spec.whatwg.org/multipage/parsing.html#charref-in-attribute
     auto Tokenizer::consumed_part_of_attribute() const noexcept -> bool
     {
@@ -206,7 +449,25 @@ namespace Hanami::HTML {
         }
     }
 
+    // The lowercase version of an ASCII upper alpha character, without going through the C locale like std::tolower() does.
+    static auto to_ascii_lowercase(char c) noexcept -> char
+    {
+        return is_ascii_upper_alpha(c) ? static_cast<char>(c + 0x20) : c;
+    }
+
+    template<typename Traits>
+    void Tokenizer::parse_error(ErrorType type)
+    {
+        if constexpr (Traits::report_parse_errors)
+        {
+            // NOTE: Nothing was consumed once the end of the input has been reached.
+            const auto offset = m_reached_eof || m_current_char_idx == 0 ? m_current_char_idx : m_current_char_idx - 1;
+            m_parse_errors->push_back({ type, offset });
+        }
+    }
+
     // https://html.spec.whatwg.org/multipage/parsing.html#tokenization
+    template<typename Traits>
     auto Tokenizer::process_next_token() -> ProcessResult
     {
         switch (m_state)
@@ -236,15 +497,21 @@ namespace Hanami::HTML {
 
                 if (c == '<') // U+003C LESS-THAN SIGN (<)
                 {
+                    // NOTE: Most markup is one of a few exact byte patterns, which don't need the states below.
+                    if (try_consume_common_markup())
+                    {
+                        break;
+                    }
+
                     // Switch to the tag open state.
                     m_state = State::TagOpen;
                     break;
                 }
 
-                if (c == '\0') // U+0000 NULL
+                if (Traits::may_contain_nul && c == '\0') // U+0000 NULL
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Emit the current input character as a character token.
                     emit_token(CharacterToken{ c });
@@ -265,7 +532,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-before-tag-name parse error.
-                    // parse_error(ErrorType::EOFBeforeTagName);
+                    parse_error<Traits>(ErrorType::EOFBeforeTagName);
 
                     // Emit a U+003C LESS-THAN SIGN character token and an end-of-file token.
                     emit_token(CharacterToken{ '<' });
@@ -300,7 +567,7 @@ namespace Hanami::HTML {
                 if (c == '?') // U+003F QUESTION MARK (?)
                 {
                     // This is an unexpected-question-mark-instead-of-tag-name parse error.
-                    // parse_error(ErrorType::UnexpectedQuestionMarkInsteadOfTagName);
+                    parse_error<Traits>(ErrorType::UnexpectedQuestionMarkInsteadOfTagName);
 
                     // Create a comment token whose data is the empty string.
                     m_current_token = CommentToken{ "" };
@@ -312,7 +579,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is an invalid-first-character-of-tag-name parse error.
-                // parse_error(ErrorType::InvalidFirstCharacterOfTagName);
+                parse_error<Traits>(ErrorType::InvalidFirstCharacterOfTagName);
 
                 // Emit a U+003C LESS-THAN SIGN character token.
                 emit_token(CharacterToken{ '<' });
@@ -330,7 +597,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-before-tag-name parse error.
-                    // parse_error(ErrorType::EOFBeforeTagName);
+                    parse_error<Traits>(ErrorType::EOFBeforeTagName);
 
                     // Emit a U+003C LESS-THAN SIGN character token, a U+002F SOLIDUS character token and an end-of-file token.
                     emit_token(CharacterToken{ '<' });
@@ -354,7 +621,7 @@ namespace Hanami::HTML {
                 if (c == '>')
                 {
                     // This is a missing-end-tag-name parse error.
-                    // parse_error(ErrorType::MissingEndTagName);
+                    parse_error<Traits>(ErrorType::MissingEndTagName);
 
                     // Switch to the data state.
                     m_state = State::Data;
@@ -363,7 +630,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is an invalid-first-character-of-tag-name parse error.
-                // parse_error(ErrorType::InvalidFirstCharacterOfTagName);
+                parse_error<Traits>(ErrorType::InvalidFirstCharacterOfTagName);
 
                 // Create a comment token whose data is the empty string.
                 m_current_token = CommentToken{ "" };
@@ -405,18 +672,34 @@ namespace Hanami::HTML {
                 {
                     // Consume those characters.
                     consume_multiple_chars(std::strlen("[CDATA["));
-                    
+
+                    // The adjusted current node is owned by the tree builder, make sure it has processed everything we've emitted so far.
+                    if (m_sync)
+                    {
+                        m_sync();
+                    }
+
                     // If there is an adjusted current node and it is not an element in the HTML namespace, then switch to the CDATA section state.
+                    if (m_in_foreign_content && m_in_foreign_content())
+                    {
+                        m_state = State::CDATASection;
+                        break;
+                    }
+
                     // Otherwise, this is a cdata-in-html-content parse error.
+                    parse_error<Traits>(ErrorType::CDATAInHTMLContent);
+
                     // Create a comment token whose data is the "[CDATA[" string.
+                    m_current_token = CommentToken{ "[CDATA[" };
+
                     // Switch to the bogus comment state.
-                    NOT_IMPLEMENTED();
+                    m_state = State::BogusComment;
                     break;
                 }
 
                 // Anything else
                 // This is an incorrectly-opened-comment parse error.
-                // parse_error(ErrorType::IncorrectlyOpenedComment);
+                parse_error<Traits>(ErrorType::IncorrectlyOpenedComment);
 
                 // Create a comment token whose data is the empty string.
                 m_current_token = CommentToken{ "" };
@@ -434,7 +717,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-doctype parse error.
-                    // parse_error(ErrorType::EOFInDOCTYPE);
+                    parse_error<Traits>(ErrorType::EOFInDOCTYPE);
 
                     // Create a new DOCTYPE token.
                     // Set its force-quirks flag to on.
@@ -470,7 +753,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is a missing-whitespace-before-doctype-name parse error.
-                // parse_error(ErrorType::MissingWhitespaceBeforeDOCTYPEName);
+                parse_error<Traits>(ErrorType::MissingWhitespaceBeforeDOCTYPEName);
 
                 // Reconsume in the before DOCTYPE name state.
                 reconsume_in(State::BeforeDOCTYPEName);
@@ -485,7 +768,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-doctype parse error.
-                    // parse_error(ErrorType::EOFInDOCTYPE);
+                    parse_error<Traits>(ErrorType::EOFInDOCTYPE);
 
                     // Create a new DOCTYPE token.
                     // Set its force-quirks flag to on.
@@ -517,7 +800,7 @@ namespace Hanami::HTML {
                     // Create a new DOCTYPE token.
                     // Set the token's name to the lowercase version of the current input character (add 0x0020 to the character's code point).
                     m_current_token = DOCTYPEToken {
-                        .name = std::string{ static_cast<char>(std::tolower(c)) }
+                        .name = std::string{ to_ascii_lowercase(c) }
                     };
 
                     // Switch to the DOCTYPE name state.
@@ -526,10 +809,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Create a new DOCTYPE token.
                     // Set the token's name to a U+FFFD REPLACEMENT CHARACTER character.
@@ -546,7 +829,7 @@ namespace Hanami::HTML {
                 if (c == '>')
                 {
                     // This is a missing-doctype-name parse error.
-                    // parse_error(ErrorType::MissingDOCTYPEName);
+                    parse_error<Traits>(ErrorType::MissingDOCTYPEName);
 
                     // Create a new DOCTYPE token.
                     // Set its force-quirks flag to on.
@@ -578,7 +861,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-doctype parse error.
-                    // parse_error(ErrorType::EOFInDOCTYPE);
+                    parse_error<Traits>(ErrorType::EOFInDOCTYPE);
 
                     // Set the current DOCTYPE token's force-quirks flag to on.
                     std::get<DOCTYPEToken>(m_current_token).force_quirks = true;
@@ -617,15 +900,15 @@ namespace Hanami::HTML {
                 if (is_ascii_upper_alpha(c))
                 {
                     // Append the lowercase version of the current input character (add 0x0020 to the character's code point) to the current DOCTYPE token's name.
-                    std::get<DOCTYPEToken>(m_current_token).name += static_cast<char>(std::tolower(c));
+                    std::get<DOCTYPEToken>(m_current_token).name += to_ascii_lowercase(c);
                     break;
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the current DOCTYPE token's name.
                     std::get<DOCTYPEToken>(m_current_token).name += "�";
@@ -705,7 +988,7 @@ namespace Hanami::HTML {
                         break;
                     }
 
-                    if (named_character_references.contains(m_temporary_buffer))
+                    if (find_named_character_reference(m_temporary_buffer))
                     {
                         longest_match = m_temporary_buffer;
                         chars_consumed_since_longest_match = 0;
@@ -715,6 +998,12 @@ namespace Hanami::HTML {
                     {
                         break;
                     }
+
+                    if (!is_named_character_reference_prefix(m_temporary_buffer))
+                    {
+                        // No longer match possible, stop consuming instead of scanning up to the longest name.
+                        break;
+                    }
                 }
 
                 // We might have overconsumed a bunch of characters to make sure
@@ -745,14 +1034,14 @@ namespace Hanami::HTML {
                     // If the last character matched is not a U+003B SEMICOLON character (;), then this is a missing-semicolon-after-character-reference parse error.
                     if (longest_match.back() != ';')
                     {
-                        // parse_error(ErrorType::MissingSemicolonAfterCharacterReference);
+                        parse_error<Traits>(ErrorType::MissingSemicolonAfterCharacterReference);
                     }
 
                     // Set the temporary buffer to the empty string.
                     m_temporary_buffer.clear();
 
                     // Append one or two characters corresponding to the character reference name (as given by the second column of the named character references table) to the temporary buffer.
-                    m_temporary_buffer += named_character_references.at(longest_match);
+                    m_temporary_buffer += *find_named_character_reference(longest_match);
 
                     // Flush code points consumed as a character reference.
                     flush_consumed_code_points();
@@ -815,7 +1104,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is an absence-of-digits-in-numeric-character-reference parse error.
-                // parse_error(ErrorType::AbsenceOfDigitsInNumericCharacterReference);
+                parse_error<Traits>(ErrorType::AbsenceOfDigitsInNumericCharacterReference);
 
                 // Flush code points consumed as a character reference.
                 flush_consumed_code_points();
@@ -849,7 +1138,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is a missing-semicolon-after-character-reference parse error.
-                // parse_error(ErrorType::MissingSemicolonAfterCharacterReference);
+                parse_error<Traits>(ErrorType::MissingSemicolonAfterCharacterReference);
 
                 // Reconsume in the numeric character reference end state.
                 reconsume_in(State::NumericCharacterReferenceEnd);
@@ -862,7 +1151,7 @@ namespace Hanami::HTML {
                 if (m_character_reference_code == 0x00)
                 {
                     // then this is a null-character-reference parse error.
-                    // parse_error(ErrorType::NullCharacterReference);
+                    parse_error<Traits>(ErrorType::NullCharacterReference);
 
                     // Set the character reference code to 0xFFFD.
                     m_character_reference_code = 0xFFFD;
@@ -871,7 +1160,7 @@ namespace Hanami::HTML {
                 else if (m_character_reference_code > 0x10FFF)
                 {
                     // then this is a character-reference-outside-unicode-range parse error.
-                    // parse_error(ErrorType::CharacterReferenceOutsideUnicodeRange);
+                    parse_error<Traits>(ErrorType::CharacterReferenceOutsideUnicodeRange);
 
                     // Set the character reference code to 0xFFFD.
                     m_character_reference_code = 0xFFFD;
@@ -880,7 +1169,7 @@ namespace Hanami::HTML {
                 else if (is_unicode_surrogate(m_character_reference_code))
                 {
                     // then this is a surrogate-character-reference parse error.
-                    // parse_error(ErrorType::SurrogateCharacterReference);
+                    parse_error<Traits>(ErrorType::SurrogateCharacterReference);
 
                     // Set the character reference code to 0xFFFD.
                     m_character_reference_code = 0xFFFD;
@@ -889,13 +1178,13 @@ namespace Hanami::HTML {
                 else if (is_unicode_noncharacter(m_character_reference_code))
                 {
                     // then this is a noncharacter-character-reference parse error.
-                    // parse_error(ErrorType::NonCharacterCharacterReference);
+                    parse_error<Traits>(ErrorType::NonCharacterCharacterReference);
                 }
                 // If the number is 0x0D, or a control that's not ASCII whitespace,
                 else if (m_character_reference_code == 0x0D || is_unicode_control(m_character_reference_code))
                 {
                     // then this is a control-character-reference parse error.
-                    // parse_error(ErrorType::ControlCharacterReference);
+                    parse_error<Traits>(ErrorType::ControlCharacterReference);
 
                     // If the number is one of the numbers in the first column of the following table, then find the row with that number in the first column, and set the character reference code to the number in the second column of that row.
                     if (m_character_reference_code == 0x80)
@@ -1012,11 +1301,18 @@ namespace Hanami::HTML {
                 m_temporary_buffer = "";
 
                 // Append a code point equal to the character reference code to the temporary buffer.
-                // FIXME(Peter): Hacky way around using codepoint-based strings
-                auto codepoint = Kori::Codepoint::from_utf32(m_character_reference_code);
-                for (uint8_t i = 0; i < codepoint.used_bytes; ++i)
+                if (m_character_reference_code < 0x80)
                 {
-                    m_temporary_buffer += static_cast<char>(codepoint.bytes[i]);
+                    m_temporary_buffer += static_cast<char>(m_character_reference_code);
+                }
+                else
+                {
+                    // FIXME(Peter): Hacky way around using codepoint-based strings
+                    auto codepoint = Kori::Codepoint::from_utf32(m_character_reference_code);
+                    for (uint8_t i = 0; i < codepoint.used_bytes; ++i)
+                    {
+                        m_temporary_buffer += static_cast<char>(codepoint.bytes[i]);
+                    }
                 }
 
                 // Flush code points consumed as a character reference.
@@ -1035,7 +1331,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-tag parse error.
-                    // parse_error(ErrorType::EOFInTag);
+                    parse_error<Traits>(ErrorType::EOFInTag);
 
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
@@ -1079,11 +1375,11 @@ namespace Hanami::HTML {
                     std::visit(Kori::VariantOverloadSet {
                         [&](StartTagToken& token)
                         {
-                            token.name += static_cast<char>(std::tolower(c));
+                            token.name += to_ascii_lowercase(c);
                         },
                         [&](EndTagToken& token)
                         {
-                            token.name += static_cast<char>(std::tolower(c));
+                            token.name += to_ascii_lowercase(c);
                         },
                         [](auto&&){ HANAMI_TRAP(); }
                     }, m_current_token);
@@ -1091,10 +1387,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the current tag token's tag name.
                     std::visit(Kori::VariantOverloadSet {
@@ -1116,11 +1412,11 @@ namespace Hanami::HTML {
                 std::visit(Kori::VariantOverloadSet {
                     [&](StartTagToken& token)
                     {
-                        token.name += static_cast<char>(std::tolower(c));
+                        token.name += to_ascii_lowercase(c);
                     },
                     [&](EndTagToken& token)
                     {
-                        token.name += static_cast<char>(std::tolower(c));
+                        token.name += to_ascii_lowercase(c);
                     },
                     [](auto&&){ HANAMI_TRAP(); }
                 }, m_current_token);
@@ -1135,7 +1431,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-tag parse error.
-                    // parse_error(ErrorType::EOFInTag);
+                    parse_error<Traits>(ErrorType::EOFInTag);
 
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
@@ -1168,7 +1464,7 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is an unexpected-solidus-in-tag parse error.
-                // parse_error(ErrorType::UnexpectedSolidusInTag);
+                parse_error<Traits>(ErrorType::UnexpectedSolidusInTag);
 
                 // Reconsume in the before attribute name state.
                 reconsume_in(State::BeforeAttributeName);
@@ -1199,11 +1495,18 @@ namespace Hanami::HTML {
 
                 // U+002F SOLIDUS (/)
                 // U+003E GREATER-THAN SIGN (>)
+                if (c == '/' || c == '>')
+                {
+                    // Reconsume in the after attribute name state.
+                    reconsume_in(State::AfterAttributeName);
+                    break;
+                }
+
                 // U+003D EQUALS SIGN (=)
-                if (c == '/' || c == '>' || c == '=')
+                if (c == '=')
                 {
                     // This is an unexpected-equals-sign-before-attribute-name parse error.
-                    // parse_error(ErrorType::UnexpectedEqualsSignBeforeAttributeName);
+                    parse_error<Traits>(ErrorType::UnexpectedEqualsSignBeforeAttributeName);
 
                     // Start a new attribute in the current tag token.
                     // Set that attribute's name to the current input character, and its value to the empty string.
@@ -1272,8 +1575,15 @@ namespace Hanami::HTML {
                 // U+0020 SPACE
                 // U+002F SOLIDUS (/)
                 // U+003E GREATER-THAN SIGN (>)
+                if (c == '\t' || c == '\n' || c == '\f' || c == ' ' || c == '/' || c == '>')
+                {
+                    // Reconsume in the after attribute name state.
+                    reconsume_in(State::AfterAttributeName);
+                    break;
+                }
+
                 // U+003D EQUALS SIGN (=)
-                if (c == '\t' || c == '\n' || c == '\f' || c == ' ' || c == '/' || c == '>' || c == '=')
+                if (c == '=')
                 {
                     // Switch to the before attribute value state.
                     m_state = State::BeforeAttributeValue;
@@ -1284,15 +1594,15 @@ namespace Hanami::HTML {
                 if (is_ascii_upper_alpha(c))
                 {
                     // Append the lowercase version of the current input character (add 0x0020 to the character's code point) to the current attribute's name.
-                    m_current_attribute->name += static_cast<char>(std::tolower(c));
+                    m_current_attribute->name += to_ascii_lowercase(c);
                     break;
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the current attribute's name.
                     m_current_attribute->name += "�";
@@ -1305,7 +1615,7 @@ namespace Hanami::HTML {
                 if (c == '"' || c == '\'' || c == '<')
                 {
                     // This is an unexpected-character-in-attribute-name parse error.
-                    // parse_error(ErrorType::UnexpectedCharacterInAttributeName);
+                    parse_error<Traits>(ErrorType::UnexpectedCharacterInAttributeName);
                     // Treat it as per the "anything else" entry below.
                 }
 
@@ -1314,6 +1624,83 @@ namespace Hanami::HTML {
                 m_current_attribute->name += c;
                 break;
             }
+            case State::AfterAttributeName:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // EOF
+                if (reached_eof())
+                {
+                    // This is an eof-in-tag parse error.
+                    parse_error<Traits>(ErrorType::EOFInTag);
+
+                    // Emit an end-of-file token.
+                    emit_token(EOFToken{});
+                    return ProcessResult::Abort;
+                }
+
+                // U+0009 CHARACTER TABULATION (tab)
+                // U+000A LINE FEED (LF)
+                // U+000C FORM FEED (FF)
+                // U+0020 SPACE
+                if (c == '\t' || c == '\n' || c == '\f' || c == ' ')
+                {
+                    // Ignore the character.
+                    break;
+                }
+
+                // U+002F SOLIDUS (/)
+                if (c == '/')
+                {
+                    // Switch to the self-closing start tag state.
+                    m_state = State::SelfClosingStartTag;
+                    break;
+                }
+
+                // U+003D EQUALS SIGN (=)
+                if (c == '=')
+                {
+                    // Switch to the before attribute value state.
+                    m_state = State::BeforeAttributeValue;
+                    break;
+                }
+
+                // U+003E GREATER-THAN SIGN (>)
+                if (c == '>')
+                {
+                    // Switch to the data state.
+                    m_state = State::Data;
+
+                    // Emit the current tag token.
+                    emit_token(m_current_token);
+                    break;
+                }
+
+                // Anything else
+                // Start a new attribute in the current tag token.
+                // Set that attribute name and value to the empty string.
+                auto attribute = TagAttribute {
+                    .name = "",
+                    .value =""
+                };
+
+                std::visit(Kori::VariantOverloadSet {
+                    [&](StartTagToken& token)
+                    {
+                        m_current_attribute = &token.attributes.emplace_back(std::move(attribute));
+                    },
+                    [&](EndTagToken& token)
+                    {
+                        m_current_attribute = &token.attributes.emplace_back(std::move(attribute));
+                    },
+                    [](auto&&){ HANAMI_TRAP(); }
+                }, m_current_token);
+
+                // Reconsume in the attribute name state.
+                reconsume_in(State::AttributeName);
+                break;
+            }
             case State::BeforeAttributeValue:
             {
                 // Consume the next input character:
@@ -1349,7 +1736,7 @@ namespace Hanami::HTML {
                 if (c == '>')
                 {
                     // This is a missing-attribute-value parse error.
-                    // parse_error(ErrorType::MissingAttributeValue);
+                    parse_error<Traits>(ErrorType::MissingAttributeValue);
 
                     // Switch to the data state.
                     m_state = State::Data;
@@ -1373,7 +1760,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-tag parse error.
-                    // parse_error(ErrorType::EOFInTag);
+                    parse_error<Traits>(ErrorType::EOFInTag);
 
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
@@ -1400,10 +1787,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the current attribute's value.
                     m_current_attribute->value += "�";
@@ -1424,7 +1811,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-tag parse error.
-                    // parse_error(ErrorType::EOFInTag);
+                    parse_error<Traits>(ErrorType::EOFInTag);
 
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
@@ -1465,10 +1852,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the current attribute's value.
                     m_current_attribute->value += "�";
@@ -1483,7 +1870,7 @@ namespace Hanami::HTML {
                 if (c == '"' || c == '\'' || c == '<' || c == '=' || c == '`')
                 {
                     // This is an unexpected-character-in-unquoted-attribute-value parse error.
-                    // parse_error(ErrorType::UnexpectedCharacterInUnquotedAttributeValue);
+                    parse_error<Traits>(ErrorType::UnexpectedCharacterInUnquotedAttributeValue);
 
                     // Treat it as per the "anything else" entry below.
                 }
@@ -1502,7 +1889,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-tag parse error.
-                    // parse_error(ErrorType::EOFInTag);
+                    parse_error<Traits>(ErrorType::EOFInTag);
 
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
@@ -1541,12 +1928,55 @@ namespace Hanami::HTML {
 
                 // Anything else
                 // This is a missing-whitespace-between-attributes parse error.
-                // parse_error(ErrorType::MissingWhitespaceBetweenAttributes);
+                parse_error<Traits>(ErrorType::MissingWhitespaceBetweenAttributes);
 
                 // Reconsume in the before attribute name state.
                 reconsume_in(State::BeforeAttributeName);
                 break;
             }
+            case State::BogusComment:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // EOF
+                if (reached_eof())
+                {
+                    // Emit the comment.
+                    emit_token(m_current_token);
+
+                    // Emit an end-of-file token.
+                    emit_token(EOFToken{});
+                    return ProcessResult::Abort;
+                }
+
+                // U+003E GREATER-THAN SIGN (>)
+                if (c == '>')
+                {
+                    // Switch to the data state.
+                    m_state = State::Data;
+
+                    // Emit the current comment token.
+                    emit_token(m_current_token);
+                    break;
+                }
+
+                // U+0000 NULL
+                if (Traits::may_contain_nul && c == '\0')
+                {
+                    // This is an unexpected-null-character parse error.
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
+
+                    // Append a U+FFFD REPLACEMENT CHARACTER character to the comment token's data.
+                    std::get<CommentToken>(m_current_token).data += "�";
+                    break;
+                }
+
+                // Anything else
+                // Append the current input character to the comment token's data.
+                std::get<CommentToken>(m_current_token).data += c;
+                break;
+            }
             case State::CommentStart:
             {
                 // Consume the next input character:
@@ -1564,7 +1994,7 @@ namespace Hanami::HTML {
                 if (c == '>')
                 {
                     // This is an abrupt-closing-of-empty-comment parse error.
-                    // parse_error(ErrorType::AbruptClosingOfEmptyComment);
+                    parse_error<Traits>(ErrorType::AbruptClosingOfEmptyComment);
 
                     // Switch to the data state.
                     m_state = State::Data;
@@ -1588,7 +2018,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-comment parse error.
-                    // parse_error(ErrorType::EOFInComment);
+                    parse_error<Traits>(ErrorType::EOFInComment);
 
                     // Emit the current comment token.
                     emit_token(m_current_token);
@@ -1618,10 +2048,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // Append a U+FFFD REPLACEMENT CHARACTER character to the comment token's data.
                     std::get<CommentToken>(m_current_token).data += "�";
@@ -1642,7 +2072,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-comment parse error.
-                    // parse_error(ErrorType::EOFInComment);
+                    parse_error<Traits>(ErrorType::EOFInComment);
 
                     // Emit the current comment token.
                     emit_token(m_current_token);
@@ -1677,7 +2107,7 @@ namespace Hanami::HTML {
                 if (reached_eof())
                 {
                     // This is an eof-in-comment parse error.
-                    // parse_error(ErrorType::EOFInComment);
+                    parse_error<Traits>(ErrorType::EOFInComment);
 
                     // Emit the current comment token.
                     emit_token(m_current_token);
@@ -1751,7 +2181,7 @@ namespace Hanami::HTML {
                 reconsume_in(State::Comment);
                 break;
             }
-            case State::RCDATA:
+            case State::RAWTEXT:
             {
                 // Consume the next input character:
                 const char c = consume_next_character();
@@ -1761,9 +2191,94 @@ namespace Hanami::HTML {
                 {
                     // Emit an end-of-file token.
                     emit_token(EOFToken{});
+                    return ProcessResult::Abort;
+                }
+
+                // U+003C LESS-THAN SIGN (<)
+                if (c == '<')
+                {
+                    // Switch to the RAWTEXT less-than sign state.
+                    m_state = State::RAWTEXTLessThanSign;
+                    break;
+                }
+
+                // U+0000 NULL
+                if (Traits::may_contain_nul && c == '\0')
+                {
+                    // This is an unexpected-null-character parse error.
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
+
+                    // FIXME(Peter): Handle multi-byte characters
+                    // Emit a U+FFFD REPLACEMENT CHARACTER character token.
+                    emit_token(CharacterToken{ '?' });
                     break;
                 }
 
+                // Anything else
+                //     Emit the current input character as a character token.
+                emit_token(CharacterToken{ c });
+                break;
+            }
+            case State::RAWTEXTLessThanSign:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // U+002F SOLIDUS (/)
+                if (c == '/')
+                {
+                    // Set the temporary buffer to the empty string.
+                    m_temporary_buffer = "";
+
+                    // Switch to the RAWTEXT end tag open state.
+                    m_state = State::RAWTEXTEndTagOpen;
+                    break;
+                }
+
+                // Anything else
+                //     Emit a U+003C LESS-THAN SIGN character token.
+                emit_token(CharacterToken{ '<' });
+
+                // Reconsume in the RAWTEXT state.
+                reconsume_in(State::RAWTEXT);
+                break;
+            }
+            case State::RAWTEXTEndTagOpen:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // ASCII alpha
+                if (is_ascii_alpha(c))
+                {
+                    // Create a new end tag token, set its tag name to the empty string.
+                    m_current_token = EndTagToken{};
+
+                    // Reconsume in the RAWTEXT end tag name state.
+                    reconsume_in(State::RAWTEXTEndTagName);
+                    break;
+                }
+
+                // Anything else
+                //     Emit a U+003C LESS-THAN SIGN character token and a U+002F SOLIDUS character token. Reconsume in the RAWTEXT state.
+                emit_token(CharacterToken{ '<' });
+                emit_token(CharacterToken{ '/' });
+                reconsume_in(State::RAWTEXT);
+                break;
+            }
+            case State::RCDATA:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // EOF
+                if (reached_eof())
+                {
+                    // Emit an end-of-file token.
+                    emit_token(EOFToken{});
+                    return ProcessResult::Abort;
+                }
+
                 // U+0026 AMPERSAND (&)
                 if (c == '&')
                 {
@@ -1782,10 +2297,10 @@ namespace Hanami::HTML {
                 }
 
                 // U+0000 NULL
-                if (c == '\0')
+                if (Traits::may_contain_nul && c == '\0')
                 {
                     // This is an unexpected-null-character parse error.
-                    // parse_error(ErrorType::UnexpectedNullCharacter);
+                    parse_error<Traits>(ErrorType::UnexpectedNullCharacter);
 
                     // FIXME(Peter): Handle multi-byte characters
                     // Emit a U+FFFD REPLACEMENT CHARACTER character token.
@@ -1898,8 +2413,8 @@ namespace Hanami::HTML {
                 {
                     // Append the lowercase version of the current input character (add 0x0020 to the character's code point) to the current tag token's tag name.
                     std::visit(Kori::VariantOverloadSet {
-                        [&](StartTagToken& token) { token.name += static_cast<char>(std::tolower(c)); },
-                        [&](EndTagToken& token) { token.name += static_cast<char>(std::tolower(c)); },
+                        [&](StartTagToken& token) { token.name += to_ascii_lowercase(c); },
+                        [&](EndTagToken& token) { token.name += to_ascii_lowercase(c); },
                         [](auto&&) { HANAMI_TRAP(); }
                     }, m_current_token);
 
@@ -1940,6 +2455,179 @@ namespace Hanami::HTML {
                 reconsume_in(State::RCDATA);
                 break;
             }
+            case State::RAWTEXTEndTagName:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // U+0009 CHARACTER TABULATION (tab)
+                // U+000A LINE FEED (LF)
+                // U+000C FORM FEED (FF)
+                // U+0020 SPACE
+                if (c == '\t' || c == '\n' || c == '\f' || c == ' ')
+                {
+                    // If the current end tag token is an appropriate end tag token, then switch to the before attribute name state.
+                    if (current_is_appropriate_end_tag())
+                    {
+                        m_state = State::BeforeAttributeName;
+                        break;
+                    }
+
+                    // Otherwise, treat it as per the "anything else" entry below.
+                }
+
+                // U+002F SOLIDUS (/)
+                if (c == '/')
+                {
+                    // If the current end tag token is an appropriate end tag token, then switch to the self-closing start tag state.
+                    if (current_is_appropriate_end_tag())
+                    {
+                        m_state = State::SelfClosingStartTag;
+                        break;
+                    }
+
+                    // Otherwise, treat it as per the "anything else" entry below.
+                }
+
+                // U+003E GREATER-THAN SIGN (>)
+                if (c == '>')
+                {
+                    // If the current end tag token is an appropriate end tag token, then switch to the data state and emit the current tag token.
+                    if (current_is_appropriate_end_tag())
+                    {
+                        m_state = State::Data;
+                        emit_token(m_current_token);
+                        break;
+                    }
+
+                    // Otherwise, treat it as per the "anything else" entry below.
+                }
+
+                // ASCII upper alpha
+                if (is_ascii_upper_alpha(c))
+                {
+                    // Append the lowercase version of the current input character (add 0x0020 to the character's code point) to the current tag token's tag name.
+                    std::visit(Kori::VariantOverloadSet {
+                        [&](StartTagToken& token) { token.name += to_ascii_lowercase(c); },
+                        [&](EndTagToken& token) { token.name += to_ascii_lowercase(c); },
+                        [](auto&&) { HANAMI_TRAP(); }
+                    }, m_current_token);
+
+                    // Append the current input character to the temporary buffer.
+                    m_temporary_buffer += c;
+                    break;
+                }
+
+                // ASCII lower alpha
+                if (is_ascii_lower_alpha(c))
+                {
+                    // Append the current input character to the current tag token's tag name.
+                    std::visit(Kori::VariantOverloadSet {
+                        [&](StartTagToken& token) { token.name += c; },
+                        [&](EndTagToken& token) { token.name += c; },
+                        [](auto&&) { HANAMI_TRAP(); }
+                    }, m_current_token);
+
+                    // Append the current input character to the temporary buffer.
+                    m_temporary_buffer += c;
+                    break;
+                }
+
+                // Anything else
+                // Emit a U+003C LESS-THAN SIGN character token,
+                emit_token(CharacterToken{ '<'} );
+
+                // a U+002F SOLIDUS character token,
+                emit_token(CharacterToken{ '/'} );
+
+                // and a character token for each of the characters in the temporary buffer (in the order they were added to the buffer).
+                for (const auto character : m_temporary_buffer)
+                {
+                    emit_token(CharacterToken{ character } );
+                }
+
+                // Reconsume in the RAWTEXT state.
+                reconsume_in(State::RAWTEXT);
+                break;
+            }
+            case State::CDATASection:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // EOF
+                if (reached_eof())
+                {
+                    // This is an eof-in-cdata parse error.
+                    parse_error<Traits>(ErrorType::EOFInCDATA);
+
+                    // Emit an end-of-file token.
+                    emit_token(EOFToken{});
+                    return ProcessResult::Abort;
+                }
+
+                // U+005D RIGHT SQUARE BRACKET (])
+                if (c == ']')
+                {
+                    // Switch to the CDATA section bracket state.
+                    m_state = State::CDATASectionBracket;
+                    break;
+                }
+
+                // Anything else
+                //     Emit the current input character as a character token.
+                // NOTE: U+0000 NULL characters will be handled in the tree construction stage, as part of the in foreign
+                //       content insertion mode, which is the only place where CDATA sections can appear.
+                emit_token(CharacterToken{ c });
+                break;
+            }
+            case State::CDATASectionBracket:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // U+005D RIGHT SQUARE BRACKET (])
+                if (!reached_eof() && c == ']')
+                {
+                    // Switch to the CDATA section end state.
+                    m_state = State::CDATASectionEnd;
+                    break;
+                }
+
+                // Anything else
+                //     Emit a U+005D RIGHT SQUARE BRACKET character token. Reconsume in the CDATA section state.
+                emit_token(CharacterToken{ ']' });
+                reconsume_in(State::CDATASection);
+                break;
+            }
+            case State::CDATASectionEnd:
+            {
+                // Consume the next input character:
+                const char c = consume_next_character();
+
+                // U+005D RIGHT SQUARE BRACKET (])
+                if (!reached_eof() && c == ']')
+                {
+                    // Emit a U+005D RIGHT SQUARE BRACKET character token.
+                    emit_token(CharacterToken{ ']' });
+                    break;
+                }
+
+                // U+003E GREATER-THAN SIGN character
+                if (!reached_eof() && c == '>')
+                {
+                    // Switch to the data state.
+                    m_state = State::Data;
+                    break;
+                }
+
+                // Anything else
+                //     Emit two U+005D RIGHT SQUARE BRACKET character tokens. Reconsume in the CDATA section state.
+                emit_token(CharacterToken{ ']' });
+                emit_token(CharacterToken{ ']' });
+                reconsume_in(State::CDATASection);
+                break;
+            }
             default:
             {
                 NOT_IMPLEMENTED();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "ParseError.hpp"
+
 #include "WebEngine/Core/Core.hpp"
 #include "Kori/Core.hpp"
 
@@ -125,13 +127,48 @@ namespace Hanami::HTML {
         return name;
     }
 
+    // Start tags that the tree builder may react to by switching the tokenizer state (RCDATA, RAWTEXT, script data or PLAINTEXT).
+    inline auto start_tag_may_switch_tokenizer_state(std::string_view name) -> bool
+    {
+        static constexpr std::array names = {
+            "title"sv, "textarea"sv, "style"sv, "xmp"sv, "iframe"sv,
+            "noembed"sv, "noframes"sv, "noscript"sv, "script"sv, "plaintext"sv
+        };
+
+        return std::ranges::find(names, name) != names.end();
+    }
+
     class Tokenizer
     {
     public:
         Tokenizer();
 
+        // What the input is known to contain, used to pick a specialized instantiation of the state machine.
+        struct InputProperties
+        {
+            bool contains_nul = true;
+        };
+
+        // Checks the whole input, 16 bytes at a time where SSE2 is available.
+        [[nodiscard]]
+        static auto scan_input(std::string_view input) noexcept -> InputProperties;
+
         using EmitTokenFunc = std::function<void(const Token&)>;
-        void start(std::string_view input, EmitTokenFunc func);
+        void start(std::string_view input, EmitTokenFunc func, std::optional<InputProperties> properties = std::nullopt);
+
+        // Called whenever the tokenizer is about to depend on tree construction state, i.e. after emitting a start tag
+        // that may switch the tokenizer state, and before checking the adjusted current node in the markup declaration open state.
+        // Every token emitted so far must have been processed by the tree builder once this returns.
+        using SyncFunc = std::function<void()>;
+        void set_sync_func(SyncFunc func) { m_sync = std::move(func); }
+
+        // Returns true if there is an adjusted current node and it is not an element in the HTML namespace.
+        using ForeignContentFunc = std::function<bool()>;
+        void set_foreign_content_func(ForeignContentFunc func) { m_in_foreign_content = std::move(func); }
+
+        // Parse errors are appended to errors while it is set. Reserve room up front to keep allocations out of the
+        // tokenizer, without it the states don't spend a single instruction on error reporting.
+        void set_parse_errors(std::vector<ParseError>* errors) noexcept { m_parse_errors = errors; }
 
         static void print_token(const Token& t);
 
@@ -171,6 +208,9 @@ namespace Hanami::HTML {
             CommentEndBang,
             CommentLessThanSignBang,
             RAWTEXT,
+            RAWTEXTLessThanSign,
+            RAWTEXTEndTagOpen,
+            RAWTEXTEndTagName,
             RCDATA,
             RCDATALessThanSign,
             RCDATAEndTagOpen,
@@ -180,6 +220,9 @@ namespace Hanami::HTML {
             DecimalCharacterReferenceStart,
             DecimalCharacterReference,
             NumericCharacterReferenceEnd,
+            CDATASection,
+            CDATASectionBracket,
+            CDATASectionEnd,
         };
 
         void set_state(State state) noexcept
@@ -187,6 +230,59 @@ namespace Hanami::HTML {
             m_state = state;
         }
 
+        [[nodiscard]]
+        auto state() const noexcept -> State { return m_state; }
+
+        // Offset of the next input character that will be consumed.
+        [[nodiscard]]
+        auto current_offset() const noexcept -> size_t { return m_current_char_idx; }
+
+        // Everything needed to continue tokenizing from a given point in the input.
+        struct Checkpoint
+        {
+            // The state a token in progress (and a character reference being consumed) is built up in. Only allocated
+            // for checkpoints taken in the middle of a token, so taking one between tokens stays cheap.
+            struct TokenInProgress
+            {
+                Token current_token{};
+                std::string temporary_buffer{};
+                uint32_t character_reference_code = 0;
+            };
+
+            size_t offset = 0;
+            State state = State::Data;
+            State return_state = State::Invalid;
+
+            // Used to find the appropriate end tag in the RCDATA and RAWTEXT states.
+            std::string last_start_tag_name{};
+
+            std::shared_ptr<const TokenInProgress> token_in_progress{};
+        };
+
+        [[nodiscard]]
+        auto checkpoint() const -> Checkpoint;
+
+        // Continues tokenizing from checkpoint the next time the tokenizer runs. The input has to match the input the
+        // checkpoint was taken for up to its offset.
+        void restore(const Checkpoint& checkpoint);
+
+        // Prepares the tokenizer to tokenize input from the start, without running it. Scans the input unless its
+        // properties are given, which saves tokenizers working on parts of the same input from scanning it again.
+        // Default constructed properties run the instantiation that handles any input.
+        void reset(std::string_view input, EmitTokenFunc func, std::optional<InputProperties> properties = std::nullopt);
+
+        // Runs the tokenizer until it is in the data state between two tokens at or past offset, or until it has emitted an end-of-file token.
+        // Returns true if the end-of-file token was emitted.
+        auto run_until(size_t offset) -> bool;
+
+        // Processes the next step of the state machine (usually a single input character), wherever that leaves the
+        // tokenizer, so checkpoints can be taken in the middle of a token. Returns true if the end-of-file token was emitted.
+        auto step() -> bool;
+
+        // Makes run_until() return before processing any more input, e.g. when called from the emit token callback.
+        // Cleared by reset().
+        void pause() noexcept { m_paused = true; }
+
     private:
         void emit_token(const Token& token);
 
@@ -203,11 +299,34 @@ namespace Hanami::HTML {
         [[nodiscard]]
         auto next_characters_equals(std::string_view chars, bool case_insensitive = false) const noexcept -> bool;
 
+        // The state machine is instantiated once per set of traits, which run_until() picks from for the whole run.
+        template<bool ReportParseErrors, bool MayContainNul>
+        struct TokenizerTraits
+        {
+            static constexpr bool report_parse_errors = ReportParseErrors;
+
+            // Without any U+0000 NULL characters in the input the branches replacing them can go.
+            static constexpr bool may_contain_nul = MayContainNul;
+        };
+
+        template<typename Traits>
+        auto run_states_until(size_t offset) -> bool;
+
         enum class ProcessResult { Continue, Abort };
+
+        template<typename Traits>
         auto process_next_token() -> ProcessResult;
 
+        template<typename Traits>
+        void parse_error(ErrorType type);
+
         auto current_is_appropriate_end_tag() const noexcept -> bool;
 
+        // Emits `<!DOCTYPE html>`, `<name>` or `</name>` (with a short, lowercase name) right after the `<` in the data
+        // state, comparing whole words of input instead of going through the states byte by byte. Returns false without
+        // consuming anything on any other input.
+        auto try_consume_common_markup() -> bool;
+
         auto consumed_part_of_attribute() const noexcept -> bool;
         void flush_consumed_code_points();
 
@@ -215,7 +334,11 @@ namespace Hanami::HTML {
         uint32_t m_character_reference_code;
 
         EmitTokenFunc m_emit_token;
+        SyncFunc m_sync;
+        ForeignContentFunc m_in_foreign_content;
+        std::vector<ParseError>* m_parse_errors = nullptr;
         std::string_view m_input_stream;
+        InputProperties m_input_properties{};
 
         State m_state = State::Invalid;
         State m_return_state = State::Invalid;
@@ -230,6 +353,7 @@ namespace Hanami::HTML {
         TagAttribute* m_current_attribute = nullptr;
 
         bool m_reached_eof = false;
+        bool m_paused = false;
     };
 
 }
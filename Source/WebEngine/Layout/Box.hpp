@@ -0,0 +1,194 @@
+#pragma once
+
+#include "WebEngine/DOM/Node.hpp"
+
+namespace Hanami::Layout {
+
+    struct Edges
+    {
+        double top = 0.0;
+        double right = 0.0;
+        double bottom = 0.0;
+        double left = 0.0;
+    };
+
+    // A piece of a run between two break opportunities (e.g. a word), or a line of preformatted text. Measured once
+    // when the run is built, so wrapping the run at another width only adds up widths.
+    struct TextSegment
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        double width = 0.0;
+
+        // A line may break before the segment.
+        bool break_before = false;
+
+        // Followed by a collapsible space, which isn't part of the segment. Empty segments only carry a space.
+        bool space_after = false;
+    };
+
+    // A piece of the inline content of a block container, i.e. the text of a Text node (with whitespace collapsed
+    // unless the text is preformatted) or a forced line break.
+    struct InlineRun
+    {
+        const DOM::Node* node = nullptr;
+        std::string text{};
+        std::vector<TextSegment> segments{};
+        bool forced_break = false;
+        bool preserve_whitespace = false;
+    };
+
+    // The part of a run that ended up on a line, x is relative to the start of the line.
+    struct TextFragment
+    {
+        uint32_t run = 0;
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        double x = 0.0;
+        double width = 0.0;
+    };
+
+    // y and baseline are relative to the content box of the block container.
+    struct LineBox
+    {
+        double y = 0.0;
+        double baseline = 0.0;
+        uint32_t first_fragment = 0;
+        uint32_t fragment_count = 0;
+    };
+
+    enum class BoxType : uint8_t
+    {
+        // Contains block boxes.
+        Block,
+
+        // Contains inline content only, i.e. establishes an inline formatting context.
+        InlineContainer,
+    };
+
+    // A block-level box. Inline elements don't get boxes of their own, their text becomes runs of the block container
+    // they are in. Block containers with both inline and block children get anonymous boxes (without a node) around
+    // their inline content.
+    class Box
+    {
+    public:
+        Box(DOM::Node* node, BoxType type) noexcept
+            : m_node(node), m_type(type) {}
+
+        // Null for anonymous boxes.
+        [[nodiscard]]
+        auto node() const noexcept -> const DOM::Node* { return m_node; }
+
+        [[nodiscard]]
+        auto type() const noexcept -> BoxType { return m_type; }
+
+        [[nodiscard]]
+        auto parent() const noexcept -> Box* { return m_parent; }
+
+        [[nodiscard]]
+        auto children() const noexcept -> std::span<const std::unique_ptr<Box>> { return m_children; }
+
+        // Position of the border box, relative to the border box of the parent.
+        [[nodiscard]]
+        auto x() const noexcept -> double { return m_x; }
+
+        [[nodiscard]]
+        auto y() const noexcept -> double { return m_y; }
+
+        [[nodiscard]]
+        auto width() const noexcept -> double { return m_width; }
+
+        [[nodiscard]]
+        auto height() const noexcept -> double { return m_height; }
+
+        // The contents of the box aren't laid out, and its height is only an estimate, see LayoutTree::update().
+        [[nodiscard]]
+        auto is_estimated() const noexcept -> bool { return m_estimated; }
+
+        // The box stands in for a run of its parent's children that aren't built yet, and is replaced by their boxes
+        // once it's laid out. It has no node and is always estimated.
+        [[nodiscard]]
+        auto is_deferred() const noexcept -> bool { return m_deferred_end != 0; }
+
+        // The nodes whose boxes a deferred box stands in for.
+        [[nodiscard]]
+        auto deferred_nodes() const noexcept -> std::span<DOM::Node* const>
+        {
+            return std::span{ m_parent->m_node->children() }.subspan(m_deferred_begin, m_deferred_end - m_deferred_begin);
+        }
+
+        [[nodiscard]]
+        auto margin() const noexcept -> const Edges& { return m_margin; }
+
+        [[nodiscard]]
+        auto padding() const noexcept -> const Edges& { return m_padding; }
+
+        [[nodiscard]]
+        auto runs() const noexcept -> std::span<const InlineRun> { return m_runs; }
+
+        [[nodiscard]]
+        auto fragments() const noexcept -> std::span<const TextFragment> { return m_fragments; }
+
+        [[nodiscard]]
+        auto lines() const noexcept -> std::span<const LineBox> { return m_lines; }
+
+        [[nodiscard]]
+        auto fragment_text(const TextFragment& fragment) const noexcept -> std::string_view
+        {
+            return std::string_view{ m_runs[fragment.run].text }.substr(fragment.offset, fragment.length);
+        }
+
+        // Makes the box and all its ancestors lay out again, even at the width they were laid out at before.
+        void set_needs_layout() noexcept
+        {
+            for (auto* box = this; box; box = box->m_parent)
+            {
+                box->m_needs_layout = true;
+            }
+        }
+
+    private:
+        DOM::Node* m_node = nullptr;
+        BoxType m_type = BoxType::Block;
+        bool m_needs_layout = true;
+
+        // Children are built the first time the box is laid out, so a box far away from the viewport costs nothing
+        // but itself.
+        bool m_children_built = false;
+
+        bool m_estimated = false;
+
+        // Some box below this one is estimated, so laying it out again for another part of the page can change it.
+        bool m_has_estimates = false;
+
+        // Inside a pre element, which its children inherit.
+        bool m_preserve_whitespace = false;
+
+        // The children [m_deferred_begin, m_deferred_end) of the parent's node, if the box is deferred.
+        uint32_t m_deferred_begin = 0;
+        uint32_t m_deferred_end = 0;
+
+        Box* m_parent = nullptr;
+        std::vector<std::unique_ptr<Box>> m_children;
+
+        double m_x = 0.0;
+        double m_y = 0.0;
+        double m_width = 0.0;
+        double m_height = 0.0;
+
+        Edges m_margin;
+        Edges m_padding;
+
+        // The available width the box was last laid out (or estimated) for. Unless the box needs layout, laying it out
+        // again for the same width keeps its size and everything inside it, since child positions are relative.
+        std::optional<double> m_laid_out_width;
+
+        // Inline containers only.
+        std::vector<InlineRun> m_runs;
+        std::vector<TextFragment> m_fragments;
+        std::vector<LineBox> m_lines;
+
+        friend class LayoutTree;
+    };
+
+}
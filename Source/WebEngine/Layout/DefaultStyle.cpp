@@ -0,0 +1,106 @@
+#include "DefaultStyle.hpp"
+
+namespace Hanami::Layout {
+
+    // https://html.spec.whatwg.org/multipage/rendering.html#hidden-elements
+    static constexpr std::array hidden_elements = {
+        "area"sv, "base"sv, "basefont"sv, "datalist"sv, "head"sv, "link"sv, "meta"sv, "noembed"sv, "noframes"sv,
+        "param"sv, "rp"sv, "script"sv, "style"sv, "template"sv, "title"sv,
+    };
+
+    // https://html.spec.whatwg.org/multipage/rendering.html#the-page
+    // https://html.spec.whatwg.org/multipage/rendering.html#flow-content-3
+    // NOTE: Tables and list items are laid out like any other block until there's table and list layout.
+    static constexpr std::array block_elements = {
+        "address"sv, "article"sv, "aside"sv, "blockquote"sv, "body"sv, "center"sv, "dd"sv, "details"sv, "dialog"sv,
+        "dir"sv, "div"sv, "dl"sv, "dt"sv, "fieldset"sv, "figcaption"sv, "figure"sv, "footer"sv, "form"sv, "h1"sv,
+        "h2"sv, "h3"sv, "h4"sv, "h5"sv, "h6"sv, "header"sv, "hgroup"sv, "hr"sv, "html"sv, "legend"sv, "li"sv,
+        "listing"sv, "main"sv, "menu"sv, "nav"sv, "ol"sv, "p"sv, "plaintext"sv, "pre"sv, "search"sv, "section"sv,
+        "summary"sv, "table"sv, "tbody"sv, "thead"sv, "tfoot"sv, "tr"sv, "caption"sv, "ul"sv, "xmp"sv,
+    };
+
+    // https://html.spec.whatwg.org/multipage/rendering.html#flow-content-3
+    static constexpr std::array paragraph_elements = {
+        "blockquote"sv, "dir"sv, "dl"sv, "figure"sv, "listing"sv, "menu"sv, "ol"sv, "p"sv, "plaintext"sv, "pre"sv,
+        "ul"sv, "xmp"sv, "h1"sv, "h2"sv, "h3"sv, "h4"sv, "h5"sv, "h6"sv,
+    };
+
+    // https://html.spec.whatwg.org/multipage/rendering.html#preformatted-text
+    static constexpr std::array preformatted_elements = {
+        "listing"sv, "plaintext"sv, "pre"sv, "xmp"sv,
+    };
+
+    static auto contains(std::span<const std::string_view> names, std::string_view name) -> bool
+    {
+        return std::ranges::find(names, name) != names.end();
+    }
+
+    auto default_style(const DOM::Element& element, double font_size) -> DefaultStyle
+    {
+        DefaultStyle style;
+
+        // NOTE: The rendering section only styles HTML elements, anything else (e.g. SVG) is just inline content.
+        if (!element.is_in_namespace(DOM::html_namespace))
+        {
+            return style;
+        }
+
+        const std::string_view name = element.local_name;
+
+        if (contains(hidden_elements, name))
+        {
+            style.display = Display::None;
+            return style;
+        }
+
+        if (name == "br"sv)
+        {
+            style.forced_break = true;
+            return style;
+        }
+
+        if (!contains(block_elements, name))
+        {
+            return style;
+        }
+
+        style.display = Display::Block;
+        style.preserve_whitespace = contains(preformatted_elements, name);
+
+        if (name == "body"sv)
+        {
+            style.margin = { 8.0, 8.0, 8.0, 8.0 };
+        }
+
+        if (contains(paragraph_elements, name))
+        {
+            style.margin.top = font_size;
+            style.margin.bottom = font_size;
+        }
+
+        if (name == "blockquote"sv || name == "figure"sv)
+        {
+            style.margin.left = 40.0;
+            style.margin.right = 40.0;
+        }
+
+        if (name == "dd"sv)
+        {
+            style.margin.left = 40.0;
+        }
+
+        if (name == "dir"sv || name == "menu"sv || name == "ol"sv || name == "ul"sv)
+        {
+            style.padding.left = 40.0;
+        }
+
+        if (name == "hr"sv)
+        {
+            style.margin.top = font_size * 0.5;
+            style.margin.bottom = font_size * 0.5;
+        }
+
+        return style;
+    }
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Box.hpp"
+
+#include "WebEngine/DOM/Element.hpp"
+
+namespace Hanami::Layout {
+
+    enum class Display : uint8_t
+    {
+        None,
+        Block,
+        Inline,
+    };
+
+    // The parts of an element's style layout looks at.
+    struct DefaultStyle
+    {
+        Display display = Display::Inline;
+        Edges margin;
+        Edges padding;
+        bool preserve_whitespace = false;
+        bool forced_break = false;
+    };
+
+    // The style of element according to the rendering section of the HTML standard, until there are style sheets.
+    // Lengths given in em are resolved against font_size.
+    // https://html.spec.whatwg.org/multipage/rendering.html
+    [[nodiscard]]
+    auto default_style(const DOM::Element& element, double font_size) -> DefaultStyle;
+
+}
@@ -0,0 +1,913 @@
+#include "LayoutTree.hpp"
+#include "LineBreaking.hpp"
+
+#include "WebEngine/DOM/Text.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace Hanami::Layout {
+
+    // Preformatted text only breaks at newlines, so every line is a segment of its own (empty ones included).
+    static auto find_preformatted_segments(std::string_view text) -> std::vector<TextSegment>
+    {
+        std::vector<TextSegment> segments;
+
+        for (size_t position = 0;;)
+        {
+            const auto newline = text.find('\n', position);
+            const auto end = newline == std::string_view::npos ? text.length() : newline;
+
+            segments.push_back({
+                .offset = static_cast<uint32_t>(position),
+                .length = static_cast<uint32_t>(end - position),
+            });
+
+            if (newline == std::string_view::npos)
+            {
+                return segments;
+            }
+
+            position = newline + 1;
+        }
+    }
+
+    // How far beyond either edge of the viewport boxes are laid out, in viewport heights. Enough to scroll a bit
+    // before running into boxes that only have an estimated height.
+    static constexpr double LazyOverscan = 1.0;
+
+    // Anchoring the view can bring estimated boxes into view, whose layout can move the anchor again.
+    static constexpr int MaxAnchoringPasses = 4;
+
+    // How many children of a box there are at least in a run that shares a deferred box until it's laid out. Runs only
+    // end before a block child, so they can be longer.
+    static constexpr size_t DeferredRunLength = 64;
+
+    // Children laid out in parallel are split into this many tasks per thread, so the pool can even out subtrees of
+    // very different sizes by stealing, without paying for a task per child.
+    static constexpr size_t ParallelTasksPerThread = 4;
+
+    // How much there is in box, going by the length of its source (or of its text, for anonymous boxes).
+    static auto content_length(const DOM::Document& document, const Box& box) -> double
+    {
+        if (box.is_deferred())
+        {
+            // NOTE: Some nodes (e.g. implied ones) don't have a source range, the run is assumed to start and end with
+            //       ones that do, which is what its elements and the whitespace between them usually are.
+            const auto nodes = box.deferred_nodes();
+            const auto first = document.source_range(*nodes.front());
+            const auto last = document.source_range(*nodes.back());
+            return first && last && last->end > first->begin ? static_cast<double>(last->end - first->begin) : 0.0;
+        }
+
+        if (box.node())
+        {
+            const auto range = document.source_range(*box.node());
+            return range && range->end > range->begin ? static_cast<double>(range->end - range->begin) : 0.0;
+        }
+
+        double length = 0.0;
+
+        for (const auto& run : box.runs())
+        {
+            length += static_cast<double>(run.text.length());
+        }
+
+        return length;
+    }
+
+    // Where the box is relative to the root box.
+    static auto page_y(const Box& box) -> double
+    {
+        double y = 0.0;
+
+        for (const auto* ancestor = &box; ancestor; ancestor = ancestor->parent())
+        {
+            y += ancestor->y();
+        }
+
+        return y;
+    }
+
+    // Whether any of the nodes that make up the inline content of node's box changed, i.e. its Text children and
+    // the inline elements (and what's in them) that are transparent to it.
+    static auto inline_content_changed(const DOM::Node& node, double font_size) -> bool
+    {
+        for (const auto* child : node.children())
+        {
+            if (child->type() == DOM::NodeType::Text)
+            {
+                if (child->needs_layout())
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            const auto* element = dynamic_cast<const DOM::Element*>(child);
+
+            // NOTE: Anything changing inside an inline element rebuilds the box, even if it's a block further down.
+            if (element && default_style(*element, font_size).display == Display::Inline &&
+                (element->needs_layout() || element->child_needs_layout()))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    LayoutTree::LayoutTree(MeasureTextFunc measure, const LayoutOptions& options)
+        : m_measure(std::move(measure))
+        , m_options(options)
+    {
+        if (options.thread_count != 1)
+        {
+            m_pool = std::make_unique<ThreadPool>(options.thread_count);
+        }
+    }
+
+    auto LayoutTree::update(DOM::Document& document, double viewport_width) -> bool
+    {
+        m_scroll_adjustment = 0.0;
+        m_changed_top = std::numeric_limits<double>::infinity();
+
+        const auto infinity = std::numeric_limits<double>::infinity();
+        return layout_range(document, viewport_width, -infinity, infinity);
+    }
+
+    auto LayoutTree::update(DOM::Document& document, const Viewport& viewport) -> bool
+    {
+        m_scroll_adjustment = 0.0;
+        m_changed_top = std::numeric_limits<double>::infinity();
+
+        // NOTE: Boxes are only ever destroyed while rebuilding after a change to the document, the view simply isn't
+        //       anchored then.
+        const bool rebuilding = m_document != &document || !m_root || document.needs_layout() || document.child_needs_layout();
+        const auto* anchor = rebuilding ? nullptr : find_anchor(viewport.top);
+        const auto anchor_y = anchor ? page_y(*anchor) : 0.0;
+        const auto overscan = viewport.height * LazyOverscan;
+
+        bool changed = false;
+
+        for (int pass = 0; pass < MaxAnchoringPasses; ++pass)
+        {
+            const auto top = viewport.top + m_scroll_adjustment;
+
+            if (!layout_range(document, viewport.width, top - overscan, top + viewport.height + overscan))
+            {
+                break;
+            }
+
+            changed = true;
+
+            if (!anchor || page_y(*anchor) - anchor_y == m_scroll_adjustment)
+            {
+                break;
+            }
+
+            m_scroll_adjustment = page_y(*anchor) - anchor_y;
+        }
+
+        return changed;
+    }
+
+    auto LayoutTree::layout_range(DOM::Document& document, double width, double top, double bottom) -> bool
+    {
+        // NOTE: Measured up front, rather than by whichever thread gets to lay out an inline container first.
+        if (!m_space_width)
+        {
+            m_space_width = m_measure(" ");
+        }
+
+        if (m_document != &document || !m_root)
+        {
+            m_document = &document;
+            m_root = std::make_unique<Box>(&document, BoxType::Block);
+            note_change(0.0);
+        }
+        else
+        {
+            update_box(*m_root);
+        }
+
+        return layout_box(*m_root, width, top, bottom);
+    }
+
+    auto LayoutTree::build_box(DOM::Element& element, const DefaultStyle& style, bool preserve_whitespace) -> std::unique_ptr<Box>
+    {
+        auto box = std::make_unique<Box>(&element, BoxType::Block);
+        box->m_margin = style.margin;
+        box->m_padding = style.padding;
+        box->m_preserve_whitespace = preserve_whitespace;
+
+        return box;
+    }
+
+    void LayoutTree::rebuild_children(Box& box, bool reuse)
+    {
+        ReusableBoxes old_boxes;
+
+        if (reuse)
+        {
+            for (auto& child : box.m_children)
+            {
+                if (child->m_node)
+                {
+                    old_boxes.emplace(child->m_node, std::move(child));
+                }
+            }
+        }
+
+        // The runs of the old inline content, whose segments can be kept if their text stays the same. Unlike boxes
+        // these are safe to look up by node even if the node was replaced, since the text is compared as well.
+        ReusableRuns old_runs;
+
+        auto keep_runs = [&](std::vector<InlineRun>& runs)
+        {
+            for (auto& run : runs)
+            {
+                if (!run.segments.empty())
+                {
+                    old_runs.emplace(run.node, std::move(run));
+                }
+            }
+        };
+
+        keep_runs(box.m_runs);
+
+        for (auto& child : box.m_children)
+        {
+            if (child && !child->m_node)
+            {
+                keep_runs(child->m_runs);
+            }
+        }
+
+        box.m_children.clear();
+        box.m_runs.clear();
+        box.m_fragments.clear();
+        box.m_lines.clear();
+
+        // NOTE: Only if the children changed, otherwise the old boxes in deferred runs would be lost.
+        if (reuse || !defer_children(box))
+        {
+            build_children(box, box.m_node->children(), reuse, old_boxes, old_runs);
+        }
+
+        box.m_needs_layout = true;
+        box.m_children_built = true;
+        box.m_node->clear_needs_layout();
+    }
+
+    void LayoutTree::build_children(Box& box, std::span<DOM::Node* const> nodes, bool reuse, ReusableBoxes& old_boxes, ReusableRuns& old_runs)
+    {
+        // The inline content since the last block child.
+        std::vector<InlineRun> runs;
+
+        // NOTE: Starts out set, so whitespace at the start of inline content collapses away entirely.
+        bool previous_is_space = true;
+        bool has_block_children = false;
+
+        LineBreakContext line_break_context;
+
+        auto append_text = [&](DOM::Node& node, std::string_view text, bool preserve_whitespace)
+        {
+            InlineRun run{ .node = &node, .preserve_whitespace = preserve_whitespace };
+
+            if (preserve_whitespace)
+            {
+                run.text = text;
+                previous_is_space = false;
+            }
+            else
+            {
+                // https://drafts.csswg.org/css-text/#white-space-phase-1
+                // NOTE: Collapses across runs, a space at the end of one run swallows the whitespace starting the next.
+                for (const char c : text)
+                {
+                    if (!is_ascii_whitespace(c))
+                    {
+                        run.text += c;
+                        previous_is_space = false;
+                    }
+                    else if (!previous_is_space)
+                    {
+                        run.text += ' ';
+                        previous_is_space = true;
+                    }
+                }
+            }
+
+            if (run.text.empty())
+            {
+                return;
+            }
+
+            if (const auto it = old_runs.find(&node); it != old_runs.end() && it->second.text == run.text &&
+                it->second.preserve_whitespace == preserve_whitespace)
+            {
+                run.segments = std::move(it->second.segments);
+
+                if (!preserve_whitespace)
+                {
+                    resume_text_segments(run.text, run.segments, line_break_context);
+                }
+            }
+            else
+            {
+                run.segments = preserve_whitespace
+                    ? find_preformatted_segments(run.text)
+                    : find_text_segments(run.text, line_break_context);
+
+                for (auto& segment : run.segments)
+                {
+                    segment.width = m_measure(std::string_view{ run.text }.substr(segment.offset, segment.length));
+                }
+            }
+
+            runs.push_back(std::move(run));
+        };
+
+        // Wraps the inline content since the last block child in an anonymous box.
+        auto wrap_runs = [&]
+        {
+            if (runs.empty())
+            {
+                return;
+            }
+
+            auto anonymous = std::make_unique<Box>(nullptr, BoxType::InlineContainer);
+            anonymous->m_parent = &box;
+            anonymous->m_preserve_whitespace = box.m_preserve_whitespace;
+            anonymous->m_runs = std::move(runs);
+            anonymous->m_children_built = true;
+            box.m_children.push_back(std::move(anonymous));
+
+            runs.clear();
+            line_break_context = {};
+        };
+
+        // Inline elements are transparent, their children end up in the box as if they were its own.
+        [&](this auto&& self, std::span<DOM::Node* const> children, bool reuse_children) -> void
+        {
+            for (auto* child : children)
+            {
+                if (child->type() == DOM::NodeType::Text)
+                {
+                    append_text(*child, static_cast<DOM::Text*>(child)->whole_text(), box.m_preserve_whitespace);
+                    child->clear_needs_layout();
+                    continue;
+                }
+
+                auto* element = dynamic_cast<DOM::Element*>(child);
+
+                if (!element)
+                {
+                    continue;
+                }
+
+                const auto style = default_style(*element, m_options.font_size);
+
+                if (style.display == Display::None)
+                {
+                    continue;
+                }
+
+                if (style.display == Display::Inline)
+                {
+                    if (style.forced_break)
+                    {
+                        runs.push_back({ .node = element, .forced_break = true });
+                        previous_is_space = true;
+                        line_break_context = {};
+                    }
+                    else
+                    {
+                        self(element->children(), reuse_children && !element->needs_layout());
+                    }
+
+                    element->clear_needs_layout();
+                    continue;
+                }
+
+                wrap_runs();
+                has_block_children = true;
+                previous_is_space = true;
+
+                std::unique_ptr<Box> child_box;
+
+                if (reuse_children)
+                {
+                    if (const auto it = old_boxes.find(element); it != old_boxes.end())
+                    {
+                        child_box = std::move(it->second);
+                        update_box(*child_box);
+                    }
+                }
+
+                if (!child_box)
+                {
+                    child_box = build_box(*element, style, box.m_preserve_whitespace || style.preserve_whitespace);
+                }
+
+                child_box->m_parent = &box;
+                box.m_children.push_back(std::move(child_box));
+            }
+        }(nodes, reuse);
+
+        if (has_block_children)
+        {
+            wrap_runs();
+            box.m_type = BoxType::Block;
+        }
+        else
+        {
+            box.m_runs = std::move(runs);
+            box.m_type = BoxType::InlineContainer;
+        }
+    }
+
+    auto LayoutTree::defer_children(Box& box) -> bool
+    {
+        const auto& nodes = box.m_node->children();
+
+        if (nodes.size() <= DeferredRunLength)
+        {
+            return false;
+        }
+
+        // Every run ends right before a block child, so its inline content ends up in the same anonymous boxes as it
+        // would if all the children were built at once.
+        auto starts_block = [&](const DOM::Node& node)
+        {
+            const auto* element = dynamic_cast<const DOM::Element*>(&node);
+            return element && default_style(*element, m_options.font_size).display == Display::Block;
+        };
+
+        std::vector<std::pair<size_t, size_t>> runs;
+
+        for (size_t begin = 0; begin < nodes.size();)
+        {
+            auto end = std::min(begin + DeferredRunLength, nodes.size());
+
+            while (end < nodes.size() && !starts_block(*nodes[end]))
+            {
+                ++end;
+            }
+
+            runs.emplace_back(begin, end);
+            begin = end;
+        }
+
+        if (runs.size() < 2)
+        {
+            return false;
+        }
+
+        for (const auto& [begin, end] : runs)
+        {
+            auto deferred = std::make_unique<Box>(nullptr, BoxType::Block);
+            deferred->m_parent = &box;
+            deferred->m_deferred_begin = static_cast<uint32_t>(begin);
+            deferred->m_deferred_end = static_cast<uint32_t>(end);
+            box.m_children.push_back(std::move(deferred));
+        }
+
+        box.m_type = BoxType::Block;
+        return true;
+    }
+
+    void LayoutTree::build_deferred(Box& box, size_t index)
+    {
+        const auto nodes = box.m_children[index]->deferred_nodes();
+
+        Box run(box.m_node, BoxType::Block);
+        run.m_preserve_whitespace = box.m_preserve_whitespace;
+
+        ReusableBoxes old_boxes;
+        ReusableRuns old_runs;
+        build_children(run, nodes, false, old_boxes, old_runs);
+
+        // NOTE: Only the first run can have nothing but inline content, which still needs an anonymous box among the
+        //       block boxes of the other runs.
+        if (run.m_type == BoxType::InlineContainer)
+        {
+            auto anonymous = std::make_unique<Box>(nullptr, BoxType::InlineContainer);
+            anonymous->m_preserve_whitespace = box.m_preserve_whitespace;
+            anonymous->m_runs = std::move(run.m_runs);
+            anonymous->m_children_built = true;
+            run.m_children.push_back(std::move(anonymous));
+        }
+
+        for (auto& child : run.m_children)
+        {
+            child->m_parent = &box;
+        }
+
+        box.m_children.erase(box.m_children.begin() + static_cast<ptrdiff_t>(index));
+        box.m_children.insert(box.m_children.begin() + static_cast<ptrdiff_t>(index),
+            std::make_move_iterator(run.m_children.begin()), std::make_move_iterator(run.m_children.end()));
+    }
+
+    void LayoutTree::update_box(Box& box)
+    {
+        auto* node = box.m_node;
+
+        // NOTE: Whatever changed below a box without children is picked up when they're built.
+        if (!node || !box.m_children_built || (!node->needs_layout() && !node->child_needs_layout()))
+        {
+            return;
+        }
+
+        if (node->needs_layout() || inline_content_changed(*node, m_options.font_size))
+        {
+            note_change(page_y(box));
+            rebuild_children(box, !node->needs_layout());
+            return;
+        }
+
+        // Only something inside the block children changed, their boxes are updated where they are.
+        for (auto& child : box.m_children)
+        {
+            if (const auto* child_node = child->m_node; child_node && (child_node->needs_layout() || child_node->child_needs_layout()))
+            {
+                update_box(*child);
+                box.m_needs_layout = true;
+            }
+        }
+
+        node->clear_needs_layout();
+    }
+
+    auto LayoutTree::layout_box(Box& box, double available_width, double top, double bottom) -> bool
+    {
+        const bool dirty = box.m_needs_layout || box.m_estimated || box.m_laid_out_width != available_width;
+
+        if (!dirty && !box.m_has_estimates)
+        {
+            return false;
+        }
+
+        if (!box.m_children_built)
+        {
+            rebuild_children(box, false);
+        }
+
+        box.m_width = std::max(available_width - box.m_margin.left - box.m_margin.right, 0.0);
+
+        const auto content_width = std::max(box.m_width - box.m_padding.left - box.m_padding.right, 0.0);
+        double content_height = 0.0;
+        bool changed = dirty;
+
+        if (box.m_type == BoxType::InlineContainer)
+        {
+            note_change(page_y(box));
+            content_height = layout_inline_content(box, content_width);
+            box.m_has_estimates = false;
+
+            if (const auto length = content_length(*m_document, box); length > 0.0)
+            {
+                m_sampled_area += content_width * content_height;
+                m_sampled_source_length += length;
+            }
+        }
+        else
+        {
+            // NOTE: The vertical margins of adjacent siblings collapse into the larger one. Margins don't collapse
+            //       with the parent's, nor through empty boxes.
+            double previous_margin = 0.0;
+            bool has_estimates = false;
+
+            // NOTE: Every child is in an unbounded range, so the loop below only positions the ones laid out here.
+            if (m_pool && std::isinf(top) && std::isinf(bottom))
+            {
+                changed |= layout_children_in_parallel(box, content_width);
+            }
+
+            for (size_t i = 0; i < box.m_children.size(); ++i)
+            {
+                auto& child = box.m_children[i];
+                const auto child_x = box.m_padding.left + child->m_margin.left;
+                const auto child_y = box.m_padding.top + content_height + std::max(previous_margin, child->m_margin.top);
+
+                // Children that were laid out (or estimated) for this width keep their height until they're laid out
+                // again, so the page doesn't change below the viewport while scrolling.
+                const bool up_to_date = !child->m_needs_layout && child->m_laid_out_width == content_width;
+                const auto height = up_to_date ? child->m_height : estimated_height(*child, content_width);
+
+                const bool in_range = child_y < bottom && child_y + height > top;
+
+                // A deferred run that comes into range is laid out from the first of its boxes on.
+                if (in_range && child->is_deferred())
+                {
+                    build_deferred(box, i--);
+                    changed = true;
+                    continue;
+                }
+
+                // NOTE: Positioned before it's laid out, so whatever changes inside it is noted where it ends up.
+                const bool moved = child->m_x != child_x || child->m_y != child_y;
+
+                if (moved && child->m_laid_out_width && !child->m_estimated)
+                {
+                    note_change(page_y(box) + std::min(child->m_y, child_y));
+                }
+
+                changed |= moved;
+                child->m_x = child_x;
+                child->m_y = child_y;
+
+                if (in_range)
+                {
+                    changed |= layout_box(*child, content_width, top - child_y, bottom - child_y);
+                }
+                else if (!up_to_date)
+                {
+                    changed |= estimate_box(*child, content_width);
+                }
+
+                content_height = child_y - box.m_padding.top + child->m_height;
+                previous_margin = child->m_margin.bottom;
+                has_estimates = has_estimates || child->m_estimated || child->m_has_estimates;
+            }
+
+            content_height += previous_margin;
+            box.m_has_estimates = has_estimates;
+        }
+
+        box.m_height = box.m_padding.top + content_height + box.m_padding.bottom;
+        box.m_laid_out_width = available_width;
+        box.m_needs_layout = false;
+        box.m_estimated = false;
+
+        return changed;
+    }
+
+    auto LayoutTree::layout_children_in_parallel(Box& box, double available_width) -> bool
+    {
+        // NOTE: The pool can't wait for tasks from within a task, so anything below a parallel subtree is sequential.
+        if (ThreadPool::current_worker_index())
+        {
+            return false;
+        }
+
+        // NOTE: Every deferred run would be built in the loop anyway, but after the others were laid out.
+        for (size_t i = 0; i < box.m_children.size(); ++i)
+        {
+            if (box.m_children[i]->is_deferred())
+            {
+                build_deferred(box, i);
+            }
+        }
+
+        std::vector<Box*> pending;
+
+        for (auto& child : box.m_children)
+        {
+            if (child->m_needs_layout || child->m_estimated || child->m_has_estimates || child->m_laid_out_width != available_width)
+            {
+                pending.push_back(child.get());
+            }
+        }
+
+        // A single child is laid out by the caller, which gets to look for parallelism further down.
+        if (pending.size() < 2)
+        {
+            return false;
+        }
+
+        // NOTE: The children aren't positioned until they're all laid out, so what changes inside them can't be noted
+        //       where it ends up.
+        note_change(page_y(box));
+
+        const auto infinity = std::numeric_limits<double>::infinity();
+        const auto task_count = std::min(pending.size(), m_pool->thread_count() * ParallelTasksPerThread);
+
+        // NOTE: Not std::vector<bool>, whose elements share bytes.
+        std::vector<uint8_t> task_changed(task_count, 0);
+
+        for (size_t task = 0; task < task_count; ++task)
+        {
+            const auto begin = pending.size() * task / task_count;
+            const auto end = pending.size() * (task + 1) / task_count;
+
+            m_pool->submit([this, &pending, &task_changed, task, begin, end, available_width, infinity]
+            {
+                for (auto i = begin; i < end; ++i)
+                {
+                    if (layout_box(*pending[i], available_width, -infinity, infinity))
+                    {
+                        task_changed[task] = 1;
+                    }
+                }
+            });
+        }
+
+        m_pool->wait();
+
+        return std::ranges::any_of(task_changed, [](uint8_t changed) { return changed != 0; });
+    }
+
+    void LayoutTree::note_change(double y) noexcept
+    {
+        auto changed_top = m_changed_top.load(std::memory_order_relaxed);
+
+        while (y < changed_top && !m_changed_top.compare_exchange_weak(changed_top, y, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    auto LayoutTree::estimate_box(Box& box, double available_width) -> bool
+    {
+        if (box.m_estimated && !box.m_needs_layout && box.m_laid_out_width == available_width)
+        {
+            return false;
+        }
+
+        // Its contents don't show anymore.
+        if (box.m_laid_out_width && !box.m_estimated)
+        {
+            note_change(page_y(box));
+        }
+
+        box.m_width = std::max(available_width - box.m_margin.left - box.m_margin.right, 0.0);
+        box.m_height = estimated_height(box, available_width);
+        box.m_laid_out_width = available_width;
+        box.m_needs_layout = false;
+        box.m_estimated = true;
+
+        return true;
+    }
+
+    auto LayoutTree::estimated_height(const Box& box, double available_width) const -> double
+    {
+        const auto line_height = m_options.font_size * m_options.line_height;
+
+        // NOTE: Until anything has been laid out, every character of the source is assumed to take up half an em of a line.
+        const auto area_per_character = m_sampled_source_length > 0.0
+            ? m_sampled_area / m_sampled_source_length
+            : line_height * m_options.font_size * 0.5;
+
+        const auto content_width = std::max(
+            available_width - box.m_margin.left - box.m_margin.right - box.m_padding.left - box.m_padding.right, 1.0);
+
+        const auto content_height = std::max(content_length(*m_document, box) * area_per_character / content_width, line_height);
+
+        return box.m_padding.top + content_height + box.m_padding.bottom;
+    }
+
+    auto LayoutTree::find_anchor(double top) const -> const Box*
+    {
+        // NOTE: Nothing is anchored at the very top of the page, so content that's added above stays in view.
+        if (!m_root || top <= 0.0)
+        {
+            return nullptr;
+        }
+
+        const Box* box = m_root.get();
+        double y = 0.0;
+
+        while (!box->m_estimated && box->m_type == BoxType::Block)
+        {
+            const auto it = std::ranges::find_if(box->m_children, [&](const std::unique_ptr<Box>& child)
+            {
+                return y + child->m_y + child->m_height > top;
+            });
+
+            if (it == box->m_children.end())
+            {
+                break;
+            }
+
+            // NOTE: A deferred box is replaced once it's laid out, the box before it is still there to anchor to.
+            if ((*it)->is_deferred())
+            {
+                if (it != box->m_children.begin())
+                {
+                    box = std::prev(it)->get();
+                }
+
+                break;
+            }
+
+            box = it->get();
+            y += box->m_y;
+        }
+
+        return box;
+    }
+
+    auto LayoutTree::layout_inline_content(Box& box, double available_width) -> double
+    {
+        box.m_fragments.clear();
+        box.m_lines.clear();
+
+        const auto font_size = m_options.font_size;
+        const auto line_height = font_size * m_options.line_height;
+
+        // NOTE: Assumes an ascent of 0.8em, with the leading split evenly above and below the text.
+        const auto baseline = (line_height - font_size) / 2.0 + font_size * 0.8;
+
+        double y = 0.0;
+        double x = 0.0;
+
+        // A collapsible space between the last segment and the next one, which disappears if the next one starts a line.
+        bool pending_space = false;
+        auto line_start = static_cast<uint32_t>(0);
+
+        auto finish_line = [&]
+        {
+            const auto fragment_count = static_cast<uint32_t>(box.m_fragments.size());
+
+            box.m_lines.push_back({
+                .y = y,
+                .baseline = y + baseline,
+                .first_fragment = line_start,
+                .fragment_count = fragment_count - line_start,
+            });
+
+            y += line_height;
+            x = 0.0;
+            pending_space = false;
+            line_start = fragment_count;
+        };
+
+        // Puts a segment on the current line, or the next one if it doesn't fit and may break before it.
+        auto place_segment = [&](uint32_t run_index, const TextSegment& segment, bool may_wrap)
+        {
+            auto gap = pending_space && x > 0.0 ? *m_space_width : 0.0;
+
+            if (may_wrap && x > 0.0 && x + gap + segment.width > available_width)
+            {
+                finish_line();
+                gap = 0.0;
+            }
+
+            pending_space = false;
+
+            // Segments of the same run on the same line share a fragment, spaces between them included.
+            if (box.m_fragments.size() > line_start)
+            {
+                auto& last = box.m_fragments.back();
+                const auto space_length = gap > 0.0 ? 1u : 0u;
+
+                if (last.run == run_index && last.offset + last.length + space_length == segment.offset)
+                {
+                    x += gap + segment.width;
+                    last.length = segment.offset + segment.length - last.offset;
+                    last.width = x - last.x;
+                    return;
+                }
+            }
+
+            box.m_fragments.push_back({
+                .run = run_index,
+                .offset = segment.offset,
+                .length = segment.length,
+                .x = x + gap,
+                .width = segment.width,
+            });
+
+            x += gap + segment.width;
+        };
+
+        for (uint32_t i = 0; i < box.m_runs.size(); ++i)
+        {
+            const auto& run = box.m_runs[i];
+
+            if (run.forced_break)
+            {
+                finish_line();
+                continue;
+            }
+
+            for (size_t j = 0; j < run.segments.size(); ++j)
+            {
+                const auto& segment = run.segments[j];
+
+                // Every line of preformatted text after the first starts a new line box.
+                if (run.preserve_whitespace && j > 0)
+                {
+                    finish_line();
+                }
+
+                if (segment.length > 0)
+                {
+                    place_segment(i, segment, segment.break_before);
+                }
+
+                pending_space = pending_space || segment.space_after;
+            }
+        }
+
+        if (box.m_fragments.size() > line_start)
+        {
+            finish_line();
+        }
+
+        return y;
+    }
+
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Box.hpp"
+#include "DefaultStyle.hpp"
+
+#include "WebEngine/DOM/Document.hpp"
+#include "WebEngine/Core/ThreadPool.hpp"
+
+namespace Hanami::Layout {
+
+    // Measures the horizontal advance of text in whatever font it is drawn with.
+    using MeasureTextFunc = std::function<double(std::string_view text)>;
+
+    struct LayoutOptions
+    {
+        double font_size = 16.0;
+
+        // In multiples of the font size.
+        double line_height = 1.2;
+
+        // Threads laying out independent subtrees at the same time, 0 for one per hardware thread. Anything but 1
+        // requires the measure function to be safe to call from several threads at once.
+        uint32_t thread_count = 1;
+    };
+
+    // The part of the page that's shown, in the coordinates of the root box.
+    struct Viewport
+    {
+        double width = 0.0;
+        double top = 0.0;
+        double height = 0.0;
+    };
+
+    // The boxes of a document and their layout, kept up to date incrementally.
+    //
+    // The boxes are rebuilt only below nodes whose children or text changed, going by the nodes' layout dirty bits
+    // (see DOM::Node::needs_layout()). A box is only laid out again if it was rebuilt (or is an ancestor of one that
+    // was), or if it's laid out for another available width than last time. Since every box is positioned relative to
+    // its parent, a box that hasn't changed keeps all of its contents as they are, wherever it ends up.
+    //
+    // Layout can also be limited to the part of the page around the viewport. Boxes outside of it get a height
+    // estimated from the length of their source, and their children aren't even built until they come into view. Nor
+    // are the boxes of most children of a box with many of them: runs of them share a deferred box (see
+    // Box::is_deferred()) with one estimated height until they come into view.
+    //
+    // The children of a block box only depend on its width until they're positioned, so when everything is laid out
+    // the subtrees of the first box with several children to lay out are laid out on a thread pool, and positioned in
+    // document order once they're all done.
+    class LayoutTree
+    {
+    public:
+        explicit LayoutTree(MeasureTextFunc measure, const LayoutOptions& options = {});
+
+        // Brings the boxes up to date with the document and lays all of them out for the width of the viewport.
+        // Returns true if any box was laid out again (or moved).
+        auto update(DOM::Document& document, double viewport_width) -> bool;
+
+        // Like the above, but only lays out the boxes within a viewport's height of the viewport, keeping estimated
+        // heights for the rest. Boxes that were laid out before keep their layout as long as the width doesn't change.
+        //
+        // The box at the top of the viewport is kept where it is on screen: whatever moves it (e.g. boxes above it
+        // replacing their estimates) is returned by scroll_adjustment(), which has to be added to the scroll offset.
+        // https://drafts.csswg.org/css-scroll-anchoring/
+        auto update(DOM::Document& document, const Viewport& viewport) -> bool;
+
+        // How far the last update() moved the content at the top of the viewport.
+        [[nodiscard]]
+        auto scroll_adjustment() const noexcept -> double { return m_scroll_adjustment; }
+
+        // The top of the part of the page the last update() changed, i.e. the smallest y (before or after the update)
+        // of the boxes that were laid out again, moved, or lost their layout. Everything above it looks the same as
+        // before. Infinity if nothing that shows changed, e.g. if only estimated boxes did.
+        [[nodiscard]]
+        auto changed_top() const noexcept -> double { return m_changed_top; }
+
+        // Forgets every box and measurement, e.g. after the font changed.
+        void invalidate() noexcept
+        {
+            m_root.reset();
+            m_space_width.reset();
+            m_sampled_area = 0.0;
+            m_sampled_source_length = 0.0;
+        }
+
+        // The box of the document itself, null until the first update.
+        [[nodiscard]]
+        auto root() const noexcept -> const Box* { return m_root.get(); }
+
+        [[nodiscard]]
+        auto options() const noexcept -> const LayoutOptions& { return m_options; }
+
+    private:
+        using ReusableBoxes = std::unordered_map<const DOM::Node*, std::unique_ptr<Box>>;
+        using ReusableRuns = std::unordered_map<const DOM::Node*, InlineRun>;
+
+        [[nodiscard]]
+        auto build_box(DOM::Element& element, const DefaultStyle& style, bool preserve_whitespace) -> std::unique_ptr<Box>;
+
+        // Rebuilds the children of box from its node's children. The old child boxes of nodes that are still there are
+        // kept (and updated) if reuse is set, which it mustn't be if the node's children changed, since a new node
+        // can be allocated where a removed one used to be.
+        void rebuild_children(Box& box, bool reuse);
+
+        // Appends the boxes of nodes, some of the children of box's node, to the children of box, and their inline
+        // content to its runs (or to anonymous boxes, if there are block boxes among them).
+        void build_children(Box& box, std::span<DOM::Node* const> nodes, bool reuse, ReusableBoxes& old_boxes, ReusableRuns& old_runs);
+
+        // Gives box deferred children for runs of its node's children, if there are enough of them to be worth it.
+        // Returns false if it didn't.
+        auto defer_children(Box& box) -> bool;
+
+        // Replaces the deferred child at index with the boxes of its run of nodes.
+        void build_deferred(Box& box, size_t index);
+
+        // Rebuilds whatever changed below box, going by the dirty bits of its node. The children of a box are only
+        // rebuilt if its node's children or its inline content changed, otherwise the child boxes are updated in place.
+        void update_box(Box& box);
+
+        // Builds the boxes if needed and lays out the ones that overlap [top, bottom), relative to the top of box.
+        auto layout_range(DOM::Document& document, double width, double top, double bottom) -> bool;
+
+        // Returns true if the box had to be laid out again, or any box inside it did or moved.
+        auto layout_box(Box& box, double available_width, double top, double bottom) -> bool;
+
+        // Lays out the children of box that need it on the thread pool, if there are enough of them to be worth it.
+        // Returns true if any of them was laid out.
+        auto layout_children_in_parallel(Box& box, double available_width) -> bool;
+
+        // Takes note that what shows at y and below on the page changed, see changed_top().
+        // NOTE: Boxes are positioned after they're laid out, so this may be called with where a box is about to move
+        //       away from. Whatever moves it notes the smaller of where it was and where it ends up, so that's fine.
+        void note_change(double y) noexcept;
+
+        // Gives box an estimated height (unless it already has one for this width), returning true if it changed.
+        auto estimate_box(Box& box, double available_width) -> bool;
+
+        [[nodiscard]]
+        auto estimated_height(const Box& box, double available_width) const -> double;
+
+        // The innermost box at the top of the viewport that the view is anchored to, if there is one.
+        [[nodiscard]]
+        auto find_anchor(double top) const -> const Box*;
+
+        // Breaks the runs of an inline container into lines, returning the height of the lines. Only adds up the
+        // widths the segments of the runs were measured at, so it's cheap to do again for another width.
+        auto layout_inline_content(Box& box, double available_width) -> double;
+
+        MeasureTextFunc m_measure;
+        LayoutOptions m_options;
+        std::optional<double> m_space_width;
+
+        DOM::Document* m_document = nullptr;
+        std::unique_ptr<Box> m_root;
+        double m_scroll_adjustment = 0.0;
+
+        // NOTE: Atomic, since boxes are laid out in parallel.
+        std::atomic<double> m_changed_top = 0.0;
+
+        // The content area and source length of every inline container laid out so far, which estimates go by.
+        // NOTE: Atomic, since inline containers are laid out in parallel.
+        std::atomic<double> m_sampled_area = 0.0;
+        std::atomic<double> m_sampled_source_length = 0.0;
+
+        // Null if layout is sequential.
+        std::unique_ptr<ThreadPool> m_pool;
+    };
+
+}
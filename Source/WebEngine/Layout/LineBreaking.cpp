@@ -0,0 +1,259 @@
+#include "LineBreaking.hpp"
+
+namespace Hanami::Layout {
+
+    // Decodes the code point starting at position, setting position to the one after it. Invalid sequences decode to
+    // U+FFFD one byte at a time.
+    static auto decode_utf8(std::string_view text, size_t& position) -> char32_t
+    {
+        const auto lead = static_cast<uint8_t>(text[position++]);
+
+        if (lead < 0x80)
+        {
+            return lead;
+        }
+
+        const auto length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+
+        if (length == 0 || lead > 0xF4 || position + length > text.length())
+        {
+            return U'\uFFFD';
+        }
+
+        auto code_point = static_cast<char32_t>(lead & (0x3F >> length));
+
+        for (int i = 0; i < length; ++i)
+        {
+            const auto byte = static_cast<uint8_t>(text[position + i]);
+
+            if ((byte & 0xC0) != 0x80)
+            {
+                return U'\uFFFD';
+            }
+
+            code_point = (code_point << 6) | (byte & 0x3F);
+        }
+
+        position += length;
+        return code_point;
+    }
+
+    auto line_break_class(char32_t code_point) -> LineBreakClass
+    {
+        using enum LineBreakClass;
+
+        if (code_point < 0x80)
+        {
+            switch (code_point)
+            {
+            case ' ': return SP;
+            case '\t': return BA;
+            case '!': case '?': return EX;
+            case '"': case '\'': return QU;
+            case '(': case '[': case '{': return OP;
+            case ')': case ']': return CP;
+            case '}': return CL;
+            case ',': case '.': case ':': case ';': return IS;
+            case '-': return HY;
+            case '/': return SY;
+            case '|': return BA;
+            default: return code_point >= '0' && code_point <= '9' ? NU : AL;
+            }
+        }
+
+        switch (code_point)
+        {
+        case 0x00A0: case 0x2007: case 0x202F: case 0x2060: case 0xFEFF: return GL;
+        case 0x00AD: case 0x2010: case 0x2012: case 0x2013: case 0x2014: return BA;
+        case 0x00AB: case 0x00BB: case 0x2018: case 0x2019: case 0x201C: case 0x201D: return QU;
+        case 0x3001: case 0x3002: case 0xFF0C: case 0xFF0E: return CL;
+        case 0x3005: case 0x309D: case 0x309E: case 0x30FB: case 0x30FC: case 0x30FD: case 0x30FE: return NS;
+        case 0xFF08: return OP;
+        case 0xFF09: return CP;
+        case 0xFF01: case 0xFF1F: return EX;
+        default: break;
+        }
+
+        // The CJK brackets come in pairs, opening ones at even code points.
+        if (code_point >= 0x3008 && code_point <= 0x3011)
+        {
+            return code_point % 2 == 0 ? OP : CL;
+        }
+
+        // NOTE: Hangul syllables are H2 and H3, and emoji are a mix of classes, but they all break like ideographs
+        //       outside of the sequences this doesn't handle.
+        if ((code_point >= 0x2E80 && code_point <= 0x2FFF) || (code_point >= 0x3040 && code_point <= 0x30FF) ||
+            (code_point >= 0x3400 && code_point <= 0x4DBF) || (code_point >= 0x4E00 && code_point <= 0x9FFF) ||
+            (code_point >= 0xAC00 && code_point <= 0xD7A3) || (code_point >= 0xF900 && code_point <= 0xFAFF) ||
+            (code_point >= 0x1F300 && code_point <= 0x1FAFF) || (code_point >= 0x20000 && code_point <= 0x3FFFD))
+        {
+            return ID;
+        }
+
+        return AL;
+    }
+
+    // Whether a line may break between two adjacent code points that aren't spaces.
+    static auto is_break_allowed(LineBreakClass before, LineBreakClass after) -> bool
+    {
+        using enum LineBreakClass;
+
+        // LB11, LB12, LB12a: Don't break before or after non-breaking characters.
+        if (before == GL || after == GL)
+        {
+            return false;
+        }
+
+        // LB13: Don't break before closing punctuation and separators.
+        // LB21: Don't break before hyphens and other small characters.
+        if (after == CL || after == CP || after == EX || after == IS || after == SY || after == BA || after == HY || after == NS)
+        {
+            return false;
+        }
+
+        // LB14: Don't break after opening punctuation.
+        // LB19: Don't break on either side of ambiguous quotation marks.
+        if (before == OP || before == QU || after == QU)
+        {
+            return false;
+        }
+
+        const bool after_is_word = after == AL || after == NU;
+
+        // LB25: Don't break within numbers, e.g. -1 or 3.14.
+        if ((before == HY || before == IS || before == SY) && after == NU)
+        {
+            return false;
+        }
+
+        // LB23, LB28, LB29: Don't break within words or between letters and digits, nor after a separator inside one.
+        // LB30: Don't break between a word and a parenthesis that is part of it, e.g. function(x).
+        if (((before == AL || before == NU || before == IS) && after_is_word) ||
+            ((before == AL || before == NU) && after == OP) ||
+            (before == CP && after_is_word))
+        {
+            return false;
+        }
+
+        // LB31: Break everywhere else.
+        return true;
+    }
+
+    auto LineBreakContext::allows_break_before(LineBreakClass next) const -> bool
+    {
+        using enum LineBreakClass;
+
+        if (!last)
+        {
+            return false;
+        }
+
+        if (!after_space)
+        {
+            return is_break_allowed(*last, next);
+        }
+
+        // LB18: Break after spaces, unless one of the earlier rules holds across them.
+        // LB13, LB14, LB16
+        if (next == CL || next == CP || next == EX || next == IS || next == SY)
+        {
+            return false;
+        }
+
+        return *last != OP && !((*last == CL || *last == CP) && next == NS);
+    }
+
+    auto find_text_segments(std::string_view text, LineBreakContext& context) -> std::vector<TextSegment>
+    {
+        std::vector<TextSegment> segments;
+
+        size_t start = 0;
+        bool break_before = false;
+
+        for (size_t position = 0; position < text.length();)
+        {
+            const auto begin = position;
+            const auto next_class = line_break_class(decode_utf8(text, position));
+
+            // NOTE: The text is collapsed, so a space is a single one, and ends the segment before it (which is empty if
+            //       the text starts with one).
+            if (next_class == LineBreakClass::SP)
+            {
+                segments.push_back({
+                    .offset = static_cast<uint32_t>(start),
+                    .length = static_cast<uint32_t>(begin - start),
+                    .break_before = break_before,
+                    .space_after = true,
+                });
+
+                start = position;
+                context.after_space = true;
+                continue;
+            }
+
+            if (begin == start)
+            {
+                break_before = context.allows_break_before(next_class);
+            }
+            else if (is_break_allowed(*context.last, next_class))
+            {
+                segments.push_back({
+                    .offset = static_cast<uint32_t>(start),
+                    .length = static_cast<uint32_t>(begin - start),
+                    .break_before = break_before,
+                });
+
+                start = begin;
+                break_before = true;
+            }
+
+            context.last = next_class;
+            context.after_space = false;
+        }
+
+        if (start < text.length())
+        {
+            segments.push_back({
+                .offset = static_cast<uint32_t>(start),
+                .length = static_cast<uint32_t>(text.length() - start),
+                .break_before = break_before,
+            });
+        }
+
+        return segments;
+    }
+
+    void resume_text_segments(std::string_view text, std::span<TextSegment> segments, LineBreakContext& context)
+    {
+        auto first = text.find_first_not_of(' ');
+
+        if (first == std::string_view::npos)
+        {
+            context.after_space = context.after_space || !text.empty();
+            return;
+        }
+
+        context.after_space = context.after_space || first > 0;
+
+        const auto first_class = line_break_class(decode_utf8(text, first));
+        const auto segment = std::ranges::find_if(segments, [](const TextSegment& s) { return s.length > 0; });
+
+        if (segment != segments.end())
+        {
+            segment->break_before = context.allows_break_before(first_class);
+        }
+
+        // Back to the start of the last code point that isn't a space.
+        const auto last = text.find_last_not_of(' ');
+        auto position = last;
+
+        while (position > 0 && (static_cast<uint8_t>(text[position]) & 0xC0) == 0x80)
+        {
+            --position;
+        }
+
+        context.last = line_break_class(decode_utf8(text, position));
+        context.after_space = last + 1 < text.length();
+    }
+
+}
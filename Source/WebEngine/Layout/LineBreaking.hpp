@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Box.hpp"
+
+namespace Hanami::Layout {
+
+    // https://www.unicode.org/reports/tr14/#Table1
+    // NOTE: Only the classes the rules below tell apart, every other code point is treated as AL.
+    enum class LineBreakClass : uint8_t
+    {
+        AL, // Alphabetic
+        BA, // Break after
+        CL, // Close punctuation
+        CP, // Close parenthesis
+        EX, // Exclamation/interrogation
+        GL, // Non-breaking ("glue")
+        HY, // Hyphen
+        ID, // Ideographic
+        IS, // Infix numeric separator
+        NS, // Nonstarter
+        NU, // Numeric
+        OP, // Open punctuation
+        QU, // Quotation
+        SP, // Space
+        SY, // Symbols allowing break after
+    };
+
+    [[nodiscard]]
+    auto line_break_class(char32_t code_point) -> LineBreakClass;
+
+    // What came before the text being segmented, since whether a line may break before its first code point depends
+    // on it. Carried from one run of an inline container to the next.
+    struct LineBreakContext
+    {
+        // The class of the last code point that wasn't a space, none at the start of a line.
+        std::optional<LineBreakClass> last;
+        bool after_space = false;
+
+        [[nodiscard]]
+        auto allows_break_before(LineBreakClass next) const -> bool;
+    };
+
+    // Splits collapsed text (see InlineRun) into segments at its break opportunities and its spaces, leaving the
+    // widths to be measured. Follows the pair rules of UAX #14 for the classes above, without its tailorings for
+    // numbers and emoji sequences.
+    // https://www.unicode.org/reports/tr14/#Algorithm
+    [[nodiscard]]
+    auto find_text_segments(std::string_view text, LineBreakContext& context) -> std::vector<TextSegment>;
+
+    // Brings context past text that was segmented before, updating the one break opportunity that depends on what came
+    // before it (the one before its first segment with any text).
+    void resume_text_segments(std::string_view text, std::span<TextSegment> segments, LineBreakContext& context);
+
+}
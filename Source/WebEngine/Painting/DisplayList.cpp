@@ -0,0 +1,175 @@
+#include "DisplayList.hpp"
+
+#include <algorithm>
+
+namespace Hanami::Painting {
+
+    auto Rect::united(const Rect& other) const noexcept -> Rect
+    {
+        if (other.width <= 0.0 || other.height <= 0.0)
+        {
+            return *this;
+        }
+
+        if (width <= 0.0 || height <= 0.0)
+        {
+            return other;
+        }
+
+        const auto left = std::min(x, other.x);
+        const auto top = std::min(y, other.y);
+        const auto right = std::max(x + width, other.x + other.width);
+        const auto bottom = std::max(y + height, other.y + other.height);
+
+        return { left, top, right - left, bottom - top };
+    }
+
+    void DisplayList::clear() noexcept
+    {
+        m_commands.clear();
+        m_command_bounds.clear();
+        m_text_storage.clear();
+        m_bounds = {};
+    }
+
+    void DisplayList::truncate(size_t index) noexcept
+    {
+        if (index >= m_commands.size())
+        {
+            return;
+        }
+
+        // NOTE: The texts are stored in the order of their commands, so the first removed one is where they end.
+        for (size_t i = index; i < m_commands.size(); ++i)
+        {
+            if (const auto* text = std::get_if<DrawTextCommand>(&m_commands[i]))
+            {
+                m_text_storage.resize(text->text_offset);
+                break;
+            }
+        }
+
+        m_commands.resize(index);
+        m_command_bounds.resize(index);
+        m_bounds = {};
+
+        for (const auto& bounds : m_command_bounds)
+        {
+            m_bounds = m_bounds.united(bounds);
+        }
+    }
+
+    void DisplayList::fill_rect(const Rect& rect, const Color& color)
+    {
+        append(FillRectCommand{ rect, color }, rect);
+    }
+
+    void DisplayList::draw_text(double x, double baseline, std::string_view text, double width, double font_size, const Color& color)
+    {
+        const auto text_offset = static_cast<uint32_t>(m_text_storage.length());
+        m_text_storage += text;
+        m_text_storage += '\0';
+
+        // NOTE: Descenders go below the baseline, a quarter of the font size covers them for common fonts.
+        const auto bounds = Rect { x, baseline - font_size, width, font_size * 1.25 };
+
+        append(DrawTextCommand {
+            .x = x,
+            .baseline = baseline,
+            .font_size = font_size,
+            .color = color,
+            .text_offset = text_offset,
+            .text_length = static_cast<uint32_t>(text.length()),
+        }, bounds);
+    }
+
+    void DisplayList::append(DisplayCommand command, const Rect& bounds)
+    {
+        m_commands.push_back(std::move(command));
+        m_command_bounds.push_back(bounds);
+        m_bounds = m_bounds.united(bounds);
+    }
+
+    // Records the lines whose baselines are at from_y or below.
+    static void record_lines_from(DisplayList& list, const Layout::LayoutTree& tree, const Color& color, double from_y)
+    {
+        if (!tree.root())
+        {
+            return;
+        }
+
+        const auto font_size = tree.options().font_size;
+
+        // x and y are where the box's parent is on the page.
+        [&](this auto&& self, const Layout::Box& box, double x, double y) -> void
+        {
+            // NOTE: Whatever is inside an estimated box may have been laid out for another width, if at all.
+            //       No baseline is below the bottom of its line, so a box ending above from_y has none at or below it.
+            if (box.is_estimated() || y + box.y() + box.height() < from_y)
+            {
+                return;
+            }
+
+            x += box.x();
+            y += box.y();
+
+            const auto content_x = x + box.padding().left;
+            const auto content_y = y + box.padding().top;
+            const auto fragments = box.fragments();
+
+            for (const auto& line : box.lines())
+            {
+                if (content_y + line.baseline < from_y)
+                {
+                    continue;
+                }
+
+                for (const auto& fragment : fragments.subspan(line.first_fragment, line.fragment_count))
+                {
+                    list.draw_text(content_x + fragment.x, content_y + line.baseline, box.fragment_text(fragment), fragment.width, font_size, color);
+                }
+            }
+
+            for (const auto& child : box.children())
+            {
+                self(*child, x, y);
+            }
+        }(*tree.root(), 0.0, 0.0);
+    }
+
+    void record_layout_tree(DisplayList& list, const Layout::LayoutTree& tree, const Color& color)
+    {
+        record_lines_from(list, tree, color, -std::numeric_limits<double>::infinity());
+    }
+
+    auto rerecord_layout_tree(DisplayList& list, const Layout::LayoutTree& tree, const Color& color, double from_y) -> RecordingChange
+    {
+        const auto commands = list.commands();
+
+        // NOTE: Lines are recorded from the top of the page down, so their baselines only ever grow.
+        const auto first = std::ranges::partition_point(commands, [&](const DisplayCommand& command)
+        {
+            const auto* text = std::get_if<DrawTextCommand>(&command);
+            return text && text->baseline < from_y;
+        }) - commands.begin();
+
+        RecordingChange change{ .first_command = static_cast<size_t>(first) };
+
+        auto note_bounds = [&]
+        {
+            for (const auto& bounds : list.command_bounds().subspan(change.first_command))
+            {
+                change.top = std::min(change.top, bounds.y);
+            }
+        };
+
+        note_bounds();
+        list.truncate(change.first_command);
+
+        record_lines_from(list, tree, color, from_y);
+        note_bounds();
+
+        return change;
+    }
+
+}
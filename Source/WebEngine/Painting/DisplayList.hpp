@@ -0,0 +1,123 @@
+#pragma once
+
+#include "WebEngine/Layout/LayoutTree.hpp"
+
+#include <span>
+#include <limits>
+#include <variant>
+
+namespace Hanami::Painting {
+
+    struct Color
+    {
+        double r = 0.0;
+        double g = 0.0;
+        double b = 0.0;
+        double a = 1.0;
+    };
+
+    struct Rect
+    {
+        double x = 0.0;
+        double y = 0.0;
+        double width = 0.0;
+        double height = 0.0;
+
+        [[nodiscard]]
+        auto intersects(const Rect& other) const noexcept -> bool
+        {
+            return x < other.x + other.width && other.x < x + width &&
+                   y < other.y + other.height && other.y < y + height;
+        }
+
+        // The smallest rect containing both, an empty rect doesn't contribute.
+        [[nodiscard]]
+        auto united(const Rect& other) const noexcept -> Rect;
+    };
+
+    struct FillRectCommand
+    {
+        Rect rect;
+        Color color;
+    };
+
+    struct DrawTextCommand
+    {
+        double x = 0.0;
+        double baseline = 0.0;
+        double font_size = 0.0;
+        Color color;
+
+        // Into the display list's text storage, see DisplayList::text().
+        uint32_t text_offset = 0;
+        uint32_t text_length = 0;
+    };
+
+    using DisplayCommand = std::variant<FillRectCommand, DrawTextCommand>;
+
+    // Draw commands in page coordinates, in painting order. Recorded whenever the layout changes and replayed for
+    // every frame, with the scroll offset applied as a translation by whoever replays it.
+    class DisplayList
+    {
+    public:
+        void clear() noexcept;
+
+        // Removes the commands from the one at index on.
+        void truncate(size_t index) noexcept;
+
+        void fill_rect(const Rect& rect, const Color& color);
+
+        // width is the text's advance, which only goes into the bounds of the command.
+        void draw_text(double x, double baseline, std::string_view text, double width, double font_size, const Color& color);
+
+        [[nodiscard]]
+        auto commands() const noexcept -> std::span<const DisplayCommand> { return m_commands; }
+
+        // The area every command paints into, parallel to commands(). Used to skip commands outside the viewport.
+        [[nodiscard]]
+        auto command_bounds() const noexcept -> std::span<const Rect> { return m_command_bounds; }
+
+        // The view is null-terminated.
+        [[nodiscard]]
+        auto text(const DrawTextCommand& command) const noexcept -> std::string_view
+        {
+            return std::string_view{ m_text_storage }.substr(command.text_offset, command.text_length);
+        }
+
+        // The union of all the command bounds.
+        [[nodiscard]]
+        auto bounds() const noexcept -> Rect { return m_bounds; }
+
+    private:
+        void append(DisplayCommand command, const Rect& bounds);
+
+        std::vector<DisplayCommand> m_commands;
+        std::vector<Rect> m_command_bounds;
+
+        // NOTE: The text of all commands lives in one buffer, so recording doesn't allocate per command.
+        //       Every text is followed by a null character for the C APIs drawing it.
+        std::string m_text_storage;
+
+        Rect m_bounds{};
+    };
+
+    // Which commands of a display list were replaced, see rerecord_layout_tree().
+    struct RecordingChange
+    {
+        // The commands from this one on.
+        size_t first_command = 0;
+
+        // The top of the bounds of the commands that were removed or added, infinity if there weren't any.
+        double top = std::numeric_limits<double>::infinity();
+    };
+
+    // Records the text of every line box in the layout tree, in the tree's font. Lines are recorded from the top of the
+    // page down.
+    void record_layout_tree(DisplayList& list, const Layout::LayoutTree& tree, const Color& color);
+
+    // Replaces the commands recorded for the lines whose baselines are at from_y or below (usually the tree's
+    // changed_top()) with the lines there now, keeping the ones above. Those are the last commands of a list that
+    // nothing but this and record_layout_tree() recorded into.
+    auto rerecord_layout_tree(DisplayList& list, const Layout::LayoutTree& tree, const Color& color, double from_y) -> RecordingChange;
+
+}
@@ -0,0 +1,86 @@
+#include "DisplayListIndex.hpp"
+
+#include <limits>
+#include <algorithm>
+
+namespace Hanami::Painting {
+
+    void DisplayListIndex::build(const DisplayList& list)
+    {
+        const auto bounds = list.command_bounds();
+
+        m_entries.clear();
+        m_entries.reserve(bounds.size());
+
+        for (size_t i = 0; i < bounds.size(); ++i)
+        {
+            m_entries.push_back({ bounds[i].y, bounds[i].y + bounds[i].height, static_cast<uint32_t>(i) });
+        }
+
+        // NOTE: Stable, so commands starting at the same height stay in painting order.
+        std::ranges::stable_sort(m_entries, std::less{}, &Entry::top);
+
+        update_max_bottom(0);
+    }
+
+    void DisplayListIndex::update(const DisplayList& list, const RecordingChange& change)
+    {
+        // Every entry above the change stays where it is.
+        const auto begin = std::ranges::lower_bound(m_entries, change.top, std::less{}, &Entry::top) - m_entries.begin();
+
+        const auto removed = std::ranges::remove_if(m_entries.begin() + begin, m_entries.end(), [&](const Entry& entry)
+        {
+            return entry.command >= change.first_command;
+        });
+
+        m_entries.erase(removed.begin(), removed.end());
+
+        const auto bounds = list.command_bounds();
+
+        for (auto i = change.first_command; i < bounds.size(); ++i)
+        {
+            m_entries.push_back({ bounds[i].y, bounds[i].y + bounds[i].height, static_cast<uint32_t>(i) });
+        }
+
+        // NOTE: The kept entries come first and have the lower command indices, so a stable sort keeps commands
+        //       starting at the same height in painting order here as well.
+        std::stable_sort(m_entries.begin() + begin, m_entries.end(), [](const Entry& a, const Entry& b) { return a.top < b.top; });
+
+        update_max_bottom(static_cast<size_t>(begin));
+    }
+
+    void DisplayListIndex::update_max_bottom(size_t index)
+    {
+        m_max_bottom.resize(m_entries.size());
+
+        double max_bottom = index > 0 ? m_max_bottom[index - 1] : -std::numeric_limits<double>::infinity();
+
+        for (auto i = index; i < m_entries.size(); ++i)
+        {
+            max_bottom = std::max(max_bottom, m_entries[i].bottom);
+            m_max_bottom[i] = max_bottom;
+        }
+    }
+
+    void DisplayListIndex::query(double top, double bottom, std::vector<uint32_t>& out) const
+    {
+        // Everything from here on starts below the range.
+        const auto end = std::ranges::lower_bound(m_entries, bottom, std::less{}, &Entry::top) - m_entries.begin();
+
+        // Everything before this ends above the range.
+        const auto begin = std::ranges::upper_bound(m_max_bottom, top) - m_max_bottom.begin();
+
+        const auto first_found = out.size();
+
+        for (auto i = begin; i < end; ++i)
+        {
+            if (m_entries[i].bottom > top)
+            {
+                out.push_back(m_entries[i].command);
+            }
+        }
+
+        std::sort(out.begin() + static_cast<ptrdiff_t>(first_found), out.end());
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "DisplayList.hpp"
+
+namespace Hanami::Painting {
+
+    // Finds the commands of a display list whose bounds overlap a range of the page vertically, in time proportional
+    // to the number of commands found rather than the length of the list.
+    //
+    // The commands are sorted by the top of their bounds, along with the running maximum of their bottoms. The first
+    // is searched for the last command starting above the range, the second for the first command that could reach
+    // into it, and only the commands in between are visited.
+    //
+    // NOTE: A command much taller than the ones after it (e.g. a page background) keeps every command between itself
+    //       and the range in the search, which is fine while such commands are rare.
+    class DisplayListIndex
+    {
+    public:
+        void build(const DisplayList& list);
+
+        // Brings the index up to date with a list whose commands were replaced by rerecord_layout_tree(). Only the
+        // entries starting at or below the top of the change are touched.
+        void update(const DisplayList& list, const RecordingChange& change);
+
+        // Appends the indices of the commands overlapping [top, bottom) to out, in painting order.
+        void query(double top, double bottom, std::vector<uint32_t>& out) const;
+
+    private:
+        struct Entry
+        {
+            double top;
+            double bottom;
+            uint32_t command;
+        };
+
+        // Recomputes the running maximum from the entry at index on.
+        void update_max_bottom(size_t index);
+
+        std::vector<Entry> m_entries;
+
+        // The largest bottom of all the entries up to and including the same index.
+        std::vector<double> m_max_bottom;
+    };
+
+}
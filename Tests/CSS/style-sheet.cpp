@@ -0,0 +1,69 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/DOM/HTMLElement.hpp"
+
+#include "../Test.hpp"
+
+DEFINE_SIMPLE_HTML_TEST("Tests/CSS/style-sheet.html",
+{
+    using namespace Hanami::CSS;
+
+    const auto* style = doc->head() ? dynamic_cast<const Hanami::DOM::HTMLStyleElement*>(doc->head()->children()[1]) : nullptr;
+
+    // The contents are RAWTEXT, so the markup in the comment is a single text node.
+    if (!style || style->children().size() != 1 || !style->sheet())
+    {
+        HTML_TEST_FAIL("Style element");
+    }
+
+    const auto& sheet = *style->sheet();
+    const auto rules = sheet.rules();
+
+    auto declaration_text = [&](const Rule& rule, size_t index)
+    {
+        const auto& declaration = sheet.declarations(rule)[index];
+        return std::string{ sheet.property_name(declaration) } + ":" + std::string{ sheet.source_text(declaration.value) };
+    };
+
+    // The nested rules follow the ones they are nested in.
+    if (rules.size() != 9 || rules[2].type != RuleType::Media || rules[2].descendant_count != 3 || sheet.next_sibling(2) != 6 ||
+        rules[5].type != RuleType::Style || sheet.source_text(rules[5].prelude) != "& span" ||
+        rules[7].type != RuleType::FontFace || rules[8].type != RuleType::Unknown)
+    {
+        HTML_TEST_FAIL("Rules");
+    }
+
+    // Property names are interned ignoring case, values are ranges of tokens without !important.
+    const auto body = sheet.declarations(rules[0]);
+
+    if (body.size() != 2 || body[1].property != PropertyID::Color || !body[1].important || declaration_text(rules[0], 1) != "color:#333")
+    {
+        HTML_TEST_FAIL("Declarations");
+    }
+
+    // Tokens point into the source, apart from values with escapes in them.
+    const auto selector = sheet.tokens(rules[1].prelude);
+
+    if (sheet.value(selector[1]) != "a.b" || selector[4].type != TokenType::Hash || !selector[4].flag ||
+        sheet.value(sheet.tokens(sheet.declarations(rules[1])[0].value)[0]) != "images/bg.png" ||
+        declaration_text(rules[1], 1) != "--gap:4px")
+    {
+        HTML_TEST_FAIL("Tokens");
+    }
+
+    // What isn't a declaration is skipped up to the next semicolon.
+    if (sheet.declarations(rules[6]).size() != 2 || declaration_text(rules[6], 1) != "padding:1px 2px" || sheet.tokens(sheet.declarations(rules[3])[0].value)[0].number != 1.5)
+    {
+        HTML_TEST_FAIL("Error recovery");
+    }
+
+    const auto* inline_style = doc->body()->inline_style.get();
+
+    if (!inline_style || inline_style->declarations().size() != 3 ||
+        inline_style->source_text(inline_style->find(PropertyID::Color)->value) != "green" ||
+        !inline_style->find(PropertyID::MarginTop)->important)
+    {
+        HTML_TEST_FAIL("Style attribute");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,68 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+
+#include "../Test.hpp"
+
+DEFINE_HTML_TEST("Tests/Layout/incremental-layout.html", (Hanami::HTML::ParseOptions{ .incremental = true }),
+{
+    using namespace Hanami::Layout;
+
+    LayoutTree tree(measure_test_text, test_layout_options());
+
+    // The whitespace between the blocks doesn't get any boxes, the text after them gets an anonymous one.
+    if (!tree.update(*doc, 400.0) || body_boxes(tree).size() != 4)
+    {
+        HTML_TEST_FAIL("Initial layout");
+    }
+
+    const auto* first = body_boxes(tree)[0].get();
+    const auto* second = body_boxes(tree)[1].get();
+    const auto* third = body_boxes(tree)[2].get();
+    const auto* trailing = body_boxes(tree)[3].get();
+
+    if (first->width() != 384.0 || second->y() != 20.0 || third->y() != 40.0 || second->runs()[0].text != "Hello there world")
+    {
+        HTML_TEST_FAIL("Block layout");
+    }
+
+    if (tree.update(*doc, 400.0))
+    {
+        HTML_TEST_FAIL("Nothing changed, nothing should be laid out");
+    }
+
+    // The body is 100 wide, which fits "aaaa bbbb" on the first line.
+    if (!tree.update(*doc, 116.0) || first->lines().size() != 2 || first->fragment_text(first->fragments()[0]) != "aaaa bbbb")
+    {
+        HTML_TEST_FAIL("Relayout for another width");
+    }
+
+    if (second->lines().size() != 3 || third->y() != 100.0)
+    {
+        HTML_TEST_FAIL("Line breaking");
+    }
+
+    // Only the edited block is rebuilt. Its ancestors aren't, so its siblings keep their boxes, anonymous ones included.
+    (void)doc->reparse_range({ .offset = doc->source().find("Second"), .removed_length = 6, .inserted = "Third block" });
+
+    if (!tree.update(*doc, Viewport{ .width = 116.0, .top = 0.0, .height = 20.0 }) || body_boxes(tree)[0].get() != first ||
+        body_boxes(tree)[1].get() != second || body_boxes(tree)[2].get() != third || body_boxes(tree)[3].get() != trailing)
+    {
+        HTML_TEST_FAIL("Edit of one block");
+    }
+
+    // NOTE: A new box could be allocated where the old one was, but it wouldn't have been laid out before, so it'd
+    //       only get an estimate this far below the viewport.
+    if (trailing->is_estimated())
+    {
+        HTML_TEST_FAIL("Siblings of the edited block aren't rebuilt");
+    }
+
+    (void)tree.update(*doc, 116.0);
+
+    if (third->lines().size() != 2)
+    {
+        HTML_TEST_FAIL("Relayout of the edited block");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,82 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+
+#include "../Test.hpp"
+
+DEFINE_HTML_TEST("Tests/Layout/lazy-layout.html", (Hanami::HTML::ParseOptions{}),
+{
+    using namespace Hanami::Layout;
+
+    LayoutTree tree(measure_test_text, test_layout_options());
+    auto paragraphs = [&] { return body_boxes(tree); };
+
+    // The box of the body child that's at y on the page.
+    auto paragraph_at = [&](double y) -> const Box*
+    {
+        const auto found = std::ranges::find_if(paragraphs(), [&](const auto& paragraph) { return page_y(*paragraph) + paragraph->height() > y; });
+        return found != paragraphs().end() ? found->get() : nullptr;
+    };
+
+    // The body is 400 wide. Only the first run of paragraphs is built, the others share deferred boxes.
+    if (!tree.update(*doc, Viewport{ .width = 416.0, .top = 0.0, .height = 200.0 }) || paragraphs().size() >= 200)
+    {
+        HTML_TEST_FAIL("Initial layout");
+    }
+
+    // The paragraphs far below the viewport aren't laid out, and don't even have boxes yet.
+    const auto* first = paragraphs()[0].get();
+    const auto* last = paragraphs().back().get();
+
+    if (first->is_estimated() || first->lines().empty() || !last->is_deferred() || !last->is_estimated())
+    {
+        HTML_TEST_FAIL("Only the viewport is laid out");
+    }
+
+    if (tree.update(*doc, Viewport{ .width = 416.0, .top = 0.0, .height = 200.0 }))
+    {
+        HTML_TEST_FAIL("Nothing changed, nothing should be laid out");
+    }
+
+    // Scrolling far down lays out what's there, while the paragraphs in between keep their estimates.
+    (void)tree.update(*doc, Viewport{ .width = 416.0, .top = tree.root()->height() / 2.0, .height = 200.0 });
+
+    const auto* middle = paragraph_at(tree.root()->height() / 2.0);
+
+    if (!middle || middle->is_estimated() || !std::ranges::any_of(paragraphs(), [](const auto& paragraph) { return paragraph->is_deferred(); }))
+    {
+        HTML_TEST_FAIL("Layout around the viewport");
+    }
+
+    // Reflowing to another width changes the height of everything above, but the paragraph at the top of the
+    // viewport stays where it was on screen.
+    const auto top = page_y(*middle) + 5.0;
+    (void)tree.update(*doc, Viewport{ .width = 216.0, .top = top, .height = 200.0 });
+
+    if (tree.scroll_adjustment() == 0.0 || page_y(*middle) - (top + tree.scroll_adjustment()) != -5.0)
+    {
+        HTML_TEST_FAIL("Scroll anchoring");
+    }
+
+    // Laying out everything replaces every estimate, and ends up like laying out everything right away.
+    (void)tree.update(*doc, 416.0);
+
+    LayoutTree full_tree(measure_test_text, test_layout_options());
+    (void)full_tree.update(*doc, 416.0);
+
+    const auto full_paragraphs = body_boxes(full_tree);
+
+    if (std::ranges::any_of(paragraphs(), [](const auto& paragraph) { return paragraph->is_estimated(); }) || paragraphs().size() != 200)
+    {
+        HTML_TEST_FAIL("Full layout");
+    }
+
+    for (size_t i = 0; i < full_paragraphs.size(); ++i)
+    {
+        if (paragraphs()[i]->y() != full_paragraphs[i]->y() || paragraphs()[i]->height() != full_paragraphs[i]->height())
+        {
+            HTML_TEST_FAIL("Deferred runs are laid out like the rest");
+        }
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,68 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+
+#include "../Test.hpp"
+
+DEFINE_HTML_TEST("Tests/Layout/line-breaking.html", (Hanami::HTML::ParseOptions{}),
+{
+    using namespace Hanami::Layout;
+
+    size_t measure_count = 0;
+
+    LayoutTree tree([&](std::string_view text)
+    {
+        ++measure_count;
+        return measure_test_text(text);
+    }, test_layout_options());
+
+    auto lines_of = [&](size_t index)
+    {
+        const auto* box = body_boxes(tree)[index].get();
+
+        std::vector<std::string_view> lines;
+
+        for (const auto& line : box->lines())
+        {
+            for (uint32_t i = 0; i < line.fragment_count; ++i)
+            {
+                lines.push_back(box->fragment_text(box->fragments()[line.first_fragment + i]));
+            }
+        }
+
+        return lines;
+    };
+
+    // The body is 55 wide.
+    if (!tree.update(*doc, 71.0))
+    {
+        HTML_TEST_FAIL("Initial layout");
+    }
+
+    // A line may break after a hyphen.
+    if (lines_of(0) != std::vector{ "aaaa-"sv, "bbbb"sv })
+    {
+        HTML_TEST_FAIL("Break after hyphen");
+    }
+
+    // Parentheses and punctuation stick to the words they belong to.
+    if (lines_of(1) != std::vector{ "cc"sv, "(dd)"sv, "ee!"sv })
+    {
+        HTML_TEST_FAIL("Break at spaces");
+    }
+
+    // Ideographs break anywhere, except before closing punctuation.
+    if (lines_of(2) != std::vector{ "日本語で"sv, "す。"sv })
+    {
+        HTML_TEST_FAIL("Break between ideographs");
+    }
+
+    // Reflowing only adds up the widths measured before.
+    const auto initial_measure_count = measure_count;
+
+    if (!tree.update(*doc, 400.0) || measure_count != initial_measure_count || lines_of(0) != std::vector{ "aaaa-bbbb"sv })
+    {
+        HTML_TEST_FAIL("Reflow without measuring");
+    }
+
+    HTML_TEST_PASS();
+});
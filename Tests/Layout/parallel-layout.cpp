@@ -0,0 +1,42 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
+
+#include "../Test.hpp"
+
+DEFINE_HTML_TEST("Tests/Layout/parallel-layout.html", (Hanami::HTML::ParseOptions{}),
+{
+    using namespace Hanami::Layout;
+
+    LayoutTree sequential(measure_test_text, test_layout_options());
+    LayoutTree parallel(measure_test_text, test_layout_options(4));
+
+    // Both trees have the same boxes in the same places, with the same lines.
+    auto same_layout = [](this auto&& self, const Box& a, const Box& b) -> bool
+    {
+        if (a.node() != b.node() || a.x() != b.x() || a.y() != b.y() || a.width() != b.width() || a.height() != b.height() ||
+            a.lines().size() != b.lines().size() || a.fragments().size() != b.fragments().size() || a.children().size() != b.children().size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.children().size(); ++i)
+        {
+            if (!self(*a.children()[i], *b.children()[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    for (const double width : { 416.0, 216.0, 1016.0 })
+    {
+        if (!sequential.update(*doc, width) || !parallel.update(*doc, width) || !same_layout(*sequential.root(), *parallel.root()))
+        {
+            HTML_TEST_FAIL("Parallel layout");
+        }
+    }
+
+    HTML_TEST_PASS();
+});
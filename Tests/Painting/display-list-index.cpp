@@ -0,0 +1,112 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Painting/DisplayListIndex.hpp"
+
+#include "../Test.hpp"
+
+using namespace Hanami::Painting;
+
+// The commands overlapping [top, bottom), found by checking every one of them.
+static auto commands_overlapping(const DisplayList& list, double top, double bottom) -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> commands;
+
+    for (size_t i = 0; i < list.command_bounds().size(); ++i)
+    {
+        const auto& rect = list.command_bounds()[i];
+
+        if (rect.y < bottom && rect.y + rect.height > top)
+        {
+            commands.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return commands;
+}
+
+// Queries ranges around the page's edges, the edges of every command and a few bands across the page.
+static auto matches_every_command(const DisplayList& list, const DisplayListIndex& index) -> bool
+{
+    const auto page = list.bounds();
+
+    std::vector<std::pair<double, double>> ranges = {
+        { page.y - 100.0, page.y },
+        { page.y - 100.0, page.y + 1.0 },
+        { page.y, page.y + page.height },
+        { page.y + page.height - 1.0, page.y + page.height + 100.0 },
+        { page.y + page.height, page.y + page.height + 100.0 },
+        { page.y + page.height / 2.0, page.y + page.height / 2.0 },
+    };
+
+    for (const auto& rect : list.command_bounds())
+    {
+        ranges.emplace_back(rect.y, rect.y + 1.0);
+        ranges.emplace_back(rect.y - 1.0, rect.y);
+        ranges.emplace_back(rect.y + rect.height, rect.y + rect.height + 1.0);
+        ranges.emplace_back(rect.y + rect.height - 1.0, rect.y + rect.height);
+    }
+
+    for (double top = page.y - 25.0; top < page.y + page.height; top += 25.0)
+    {
+        ranges.emplace_back(top, top + 50.0);
+    }
+
+    for (const auto& [top, bottom] : ranges)
+    {
+        std::vector<uint32_t> found;
+        index.query(top, bottom, found);
+
+        // NOTE: Both are in painting order, the brute force one by construction.
+        if (found != commands_overlapping(list, top, bottom))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+DEFINE_HTML_TEST("Tests/Painting/display-list-index.html", (Hanami::HTML::ParseOptions{}),
+{
+    using namespace Hanami::Layout;
+
+    LayoutTree tree(measure_test_text, test_layout_options());
+    tree.update(*doc, Viewport{ .width = 416.0, .top = 0.0, .height = 10000.0 });
+
+    DisplayList list;
+    record_layout_tree(list, tree, {});
+
+    if (list.commands().size() < 10)
+    {
+        HTML_TEST_FAIL("Recording");
+    }
+
+    DisplayListIndex index;
+    index.build(list);
+
+    if (!matches_every_command(list, index))
+    {
+        HTML_TEST_FAIL("Queries of a built index");
+    }
+
+    // Recording the bottom half again replaces its entries, the ones above stay.
+    const auto change = rerecord_layout_tree(list, tree, {}, list.bounds().y + list.bounds().height / 2.0);
+    index.update(list, change);
+
+    if (change.first_command == 0 || change.first_command >= list.commands().size() || !matches_every_command(list, index))
+    {
+        HTML_TEST_FAIL("Queries of an updated index");
+    }
+
+    // A background as tall as the page and a band across the middle overlap lots of lines, and are painted after them.
+    const auto page = list.bounds();
+    list.fill_rect({ .x = page.x, .y = page.y, .width = page.width, .height = page.height }, {});
+    list.fill_rect({ .x = page.x, .y = page.y + page.height / 3.0, .width = page.width, .height = page.height / 3.0 }, {});
+    index.build(list);
+
+    if (!matches_every_command(list, index))
+    {
+        HTML_TEST_FAIL("Queries with overlapping commands");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,79 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/Painting/DisplayListIndex.hpp"
+
+#include "../Test.hpp"
+
+using namespace Hanami::Painting;
+
+// The bounds of the commands, which stand in for the tiles painted from them.
+static auto bounds_of(const DisplayList& list) -> std::vector<std::pair<double, double>>
+{
+    std::vector<std::pair<double, double>> bounds;
+
+    for (const auto& rect : list.command_bounds())
+    {
+        bounds.emplace_back(rect.x, rect.y);
+    }
+
+    return bounds;
+}
+
+DEFINE_HTML_TEST("Tests/Painting/scroll-repaint.html", (Hanami::HTML::ParseOptions{}),
+{
+    using namespace Hanami::Layout;
+
+    LayoutTree tree(measure_test_text, test_layout_options());
+    DisplayList list;
+    DisplayListIndex index;
+
+    // The body is 400 wide, and the window 200 high.
+    if (!tree.update(*doc, Viewport{ .width = 416.0, .top = 0.0, .height = 200.0 }) || tree.changed_top() != 0.0)
+    {
+        HTML_TEST_FAIL("Initial layout");
+    }
+
+    index.update(list, rerecord_layout_tree(list, tree, {}, tree.changed_top()));
+
+    const auto first_frame = bounds_of(list);
+
+    if (first_frame.empty())
+    {
+        HTML_TEST_FAIL("Initial recording");
+    }
+
+    // Scrolling down a window brings estimated paragraphs into the overscan below it, which changes nothing that
+    // was on screen, so the recording (and the tiles) of the first window stays.
+    if (!tree.update(*doc, Viewport{ .width = 416.0, .top = 200.0, .height = 200.0 }) || tree.scroll_adjustment() != 0.0 ||
+        tree.changed_top() < 200.0)
+    {
+        HTML_TEST_FAIL("Layout while scrolling");
+    }
+
+    const auto change = rerecord_layout_tree(list, tree, {}, tree.changed_top());
+    index.update(list, change);
+
+    const auto second_frame = bounds_of(list);
+
+    if (change.top < 200.0 || change.first_command == 0 || second_frame.size() <= first_frame.size() ||
+        !std::equal(second_frame.begin(), second_frame.begin() + static_cast<ptrdiff_t>(change.first_command), first_frame.begin()))
+    {
+        HTML_TEST_FAIL("Only what's below the first window is recorded again");
+    }
+
+    // Recording just the changed part ends up with the same list as recording everything.
+    DisplayList full_list;
+    record_layout_tree(full_list, tree, {});
+
+    if (bounds_of(full_list) != second_frame)
+    {
+        HTML_TEST_FAIL("Partial recording");
+    }
+
+    // Nothing left to lay out, nothing to record.
+    if (tree.update(*doc, Viewport{ .width = 416.0, .top = 200.0, .height = 200.0 }) || tree.changed_top() != std::numeric_limits<double>::infinity())
+    {
+        HTML_TEST_FAIL("Nothing changed");
+    }
+
+    HTML_TEST_PASS();
+});
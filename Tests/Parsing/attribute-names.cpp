@@ -0,0 +1,70 @@
+#include <fstream>
+#include <sstream>
+
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+static constexpr auto test_file = "Tests/Parsing/attribute-names.html";
+
+DEFINE_SIMPLE_HTML_TEST(test_file,
+{
+    using namespace Hanami::HTML;
+
+    std::stringstream html;
+    html << std::ifstream(test_file).rdbuf();
+    const auto source = html.str();
+
+    std::vector<StartTagToken> tags;
+    std::vector<ParseError> errors;
+    errors.reserve(16);
+
+    Tokenizer tokenizer;
+    tokenizer.set_parse_errors(&errors);
+    tokenizer.start(source, [&](const Token& token)
+    {
+        if (const auto* tag = std::get_if<StartTagToken>(&token); tag)
+        {
+            tags.push_back(*tag);
+        }
+    });
+
+    // The attributes of the start tag with the given name, as "name=value" pairs separated by spaces.
+    auto attributes = [&](std::string_view name) -> std::optional<std::string>
+    {
+        const auto it = std::ranges::find_if(tags, [&](const auto& tag) { return tag.name == name; });
+
+        if (it == tags.end())
+        {
+            return std::nullopt;
+        }
+
+        std::string result;
+
+        for (const auto& attribute : it->attributes)
+        {
+            result += (result.empty() ? "" : " ") + attribute.name + "=" + attribute.value;
+        }
+
+        return result;
+    };
+
+    // A solidus or whitespace after an attribute name ends it, rather than starting its value.
+    if (attributes("br") != "" || attributes("img") != "src=a alt=" || attributes("input") != "disabled= type=text" ||
+        attributes("a") != "title= href=x")
+    {
+        HTML_TEST_FAIL("Wrong attributes");
+    }
+
+    if (!std::ranges::all_of(tags, [](const auto& tag) { return tag.self_closing == (tag.name == "br" || tag.name == "img"); }))
+    {
+        HTML_TEST_FAIL("Wrong self-closing flags");
+    }
+
+    if (!errors.empty())
+    {
+        HTML_TEST_FAIL("Expected no parse errors");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,38 @@
+#include <mutex>
+
+#include "WebEngine/HTML/BatchParser.hpp"
+
+#include "../Test.hpp"
+
+static constexpr auto test_file = "Tests/Parsing/batch-parse.html";
+
+// Every worker reuses its own parser, and they all run at the same time. Each of them has to produce the same tree as
+// a parse on the main thread.
+DEFINE_SIMPLE_HTML_TEST(test_file,
+{
+    auto paths = std::vector<std::filesystem::path>(64, test_file);
+    paths.emplace_back("Tests/Parsing/batch-parse-missing.html");
+
+    std::mutex mutex;
+    size_t matching_documents = 0;
+
+    const auto stats = Hanami::HTML::parse_batch(paths, {}, 4, [&](const std::filesystem::path&, std::unique_ptr<Hanami::DOM::Document> document)
+    {
+        const bool matches = same_tree(document.get(), doc);
+
+        std::scoped_lock lock(mutex);
+        matching_documents += matches ? 1 : 0;
+    });
+
+    if (stats.documents != 64 || stats.failed_documents != 1)
+    {
+        HTML_TEST_FAIL("Wrong document counts");
+    }
+
+    if (matching_documents != 64)
+    {
+        HTML_TEST_FAIL("Batch parsing produced a different tree");
+    }
+
+    HTML_TEST_PASS();
+});
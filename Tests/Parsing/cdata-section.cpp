@@ -0,0 +1,61 @@
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+static constexpr auto test_file = "Tests/Parsing/cdata-section.html";
+
+// The chunks of a parallel tokenization can't tell whether "<![CDATA[" is in foreign content, they have to leave it to
+// the real tokenizer.
+DEFINE_HTML_TEST(test_file, (Hanami::HTML::ParseOptions{ .parallel_tokenization_threshold = 0, .tokenizer_threads = 4 }),
+{
+    using namespace Hanami::HTML;
+
+    const auto* expected = Parser::parse_from_file(test_file);
+
+    if (!expected)
+    {
+        HTML_TEST_FAIL("Sequential parse failed");
+    }
+
+    const bool matches = same_tree(doc, expected);
+    delete expected;
+
+    if (!matches)
+    {
+        HTML_TEST_FAIL("Parallel tokenization produced a different tree");
+    }
+
+    // The characters and comments of a CDATA section, in foreign content or in HTML content.
+    auto tokenize = [](bool in_foreign_content)
+    {
+        std::string result;
+
+        Tokenizer tokenizer;
+        tokenizer.set_foreign_content_func([=] { return in_foreign_content; });
+        tokenizer.start("<![CDATA[a<b]]c]]]>d", [&](const Token& token)
+        {
+            if (const auto* character = std::get_if<CharacterToken>(&token); character)
+            {
+                result += character->data;
+            }
+            else if (const auto* comment = std::get_if<CommentToken>(&token); comment)
+            {
+                result += "<!--" + comment->data + "-->";
+            }
+        });
+
+        return result;
+    };
+
+    if (tokenize(true) != "a<b]]c]d")
+    {
+        HTML_TEST_FAIL("Wrong CDATA section characters");
+    }
+
+    if (tokenize(false) != "<!--[CDATA[a<b]]c]]]-->d")
+    {
+        HTML_TEST_FAIL("Expected a bogus comment in HTML content");
+    }
+
+    HTML_TEST_PASS();
+});
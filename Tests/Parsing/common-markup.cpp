@@ -0,0 +1,112 @@
+#include <fstream>
+#include <sstream>
+
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+using namespace Hanami;
+
+static constexpr auto test_file = "Tests/Parsing/common-markup.html";
+
+// The same markup, with a space before the '>' of every tag that is nothing but a lowercase name and an extra space
+// in the DOCTYPE. The states tokenize it the same way, but it never matches the fast path for common markup.
+static auto without_common_markup(std::string_view source) -> std::string
+{
+    std::string result;
+
+    for (size_t i = 0; i < source.length(); ++i)
+    {
+        result += source[i];
+
+        if (source[i] != '<')
+        {
+            continue;
+        }
+
+        if (source.substr(i + 1, 8) == "!doctype" || source.substr(i + 1, 8) == "!DOCTYPE")
+        {
+            result += source.substr(i + 1, 8);
+            result += ' ';
+            i += 8;
+            continue;
+        }
+
+        auto name_end = i + 1 + (source.substr(i + 1, 1) == "/");
+        const auto name_start = name_end;
+
+        while (name_end < source.length() && (is_ascii_lower_alpha(source[name_end]) || (name_end > name_start && is_ascii_digit(source[name_end]))))
+        {
+            ++name_end;
+        }
+
+        if (name_end > name_start && source.substr(name_end, 1) == ">")
+        {
+            result += source.substr(i + 1, name_end - i - 1);
+            result += " >";
+            i = name_end;
+        }
+    }
+
+    return result;
+}
+
+static auto tokenize(std::string_view input) -> std::vector<std::string>
+{
+    std::vector<std::string> tokens;
+
+    HTML::Tokenizer tokenizer;
+    tokenizer.start(input, [&](const HTML::Token& token) { tokens.push_back(describe_token(token)); });
+
+    return tokens;
+}
+
+static constexpr auto padding = "                "sv;
+
+static constexpr std::array markup = {
+    "<!DOCTYPE html>"sv, "<!doctype HTML>"sv, "<!DocType hTmL>"sv, "<!DOCTYPE htmlx>"sv, "<!DOCTYPE html5>"sv,
+    "<b>"sv, "<h1>"sv, "<br/>"sv, "</div>"sv, "</h2>"sv, "<abcdefg>"sv, "<abcdefgh>"sv, "<B>"sv, "<a b>"sv,
+    "</p1>"sv, "<1>"sv,
+};
+
+DEFINE_SIMPLE_HTML_TEST(test_file,
+{
+    std::stringstream html;
+    html << std::ifstream(test_file).rdbuf();
+    const auto source = html.str();
+    const auto slow_source = without_common_markup(source);
+
+    if (slow_source.length() <= source.length() + 8)
+    {
+        HTML_TEST_FAIL("Expected the markup to be rewritten");
+    }
+
+    const auto slow_doc = std::unique_ptr<DOM::Document>(HTML::Parser{}.parse(slow_source));
+
+    if (tokenize(source) != tokenize(slow_source))
+    {
+        HTML_TEST_FAIL("The fast path emits different tokens");
+    }
+
+    if (!same_tree(doc, slow_doc.get()))
+    {
+        HTML_TEST_FAIL("The fast path builds a different tree");
+    }
+
+    // The fast path needs 16 bytes of input after the '<', so every piece of markup on its own is tokenized by the
+    // states, and the same markup followed by enough input takes the fast path wherever it can.
+    for (const auto piece : markup)
+    {
+        auto expected = tokenize(piece);
+        expected.pop_back();
+        expected.insert(expected.end(), padding.length(), " ");
+        expected.push_back("EOF");
+
+        if (tokenize(std::string{ piece } + std::string{ padding }) != expected)
+        {
+            HTML_TEST_FAIL("The fast path tokenizes a piece of markup differently");
+        }
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,127 @@
+#include "WebEngine/HTML/Parser.hpp"
+
+#include <unordered_set>
+
+#include "../Test.hpp"
+
+DEFINE_HTML_TEST("Tests/Parsing/incremental-reparse.html", (Hanami::HTML::ParseOptions{ .incremental = true }),
+{
+    auto replace = [&](std::string_view text, std::string_view replacement) -> const Hanami::DOM::Node*
+    {
+        return doc->reparse_range({
+            .offset = doc->source().find(text),
+            .removed_length = text.length(),
+            .inserted = std::string{ replacement },
+        });
+    };
+
+    // The re-parsed nodes and the ones after them have to end up with the same source ranges as a full parse, and
+    // the ids of the replaced nodes mustn't be left behind, i.e. they're handed out again before any new ids are.
+    // Ids only grow past the number of nodes when there are more nodes than ever before.
+    size_t most_nodes = 0;
+    std::unordered_set<uint32_t> ids;
+
+    auto same_ranges = [&](this auto&& self, const Hanami::DOM::Node* a, const Hanami::DOM::Document* a_doc,
+        const Hanami::DOM::Node* b, const Hanami::DOM::Document* b_doc) -> bool
+    {
+        const auto a_range = a_doc->source_range(*a);
+        const auto b_range = b_doc->source_range(*b);
+
+        if (a_range.has_value() != b_range.has_value() || (a_range && !ids.insert(a->id()).second))
+        {
+            return false;
+        }
+
+        if (a_range && (a_range->begin != b_range->begin || a_range->end != b_range->end))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a->children().size(); ++i)
+        {
+            if (!self(a->children()[i], a_doc, b->children()[i], b_doc))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    auto matches_full_parse = [&]
+    {
+        const auto expected = std::unique_ptr<Hanami::DOM::Document>(Hanami::HTML::Parser{}.parse(doc->source()));
+        ids.clear();
+
+        if (!same_tree(doc, expected.get()) || !same_ranges(doc, doc, expected.get(), expected.get()))
+        {
+            return false;
+        }
+
+        most_nodes = std::max(most_nodes, ids.size());
+        return std::ranges::all_of(ids, [&](uint32_t id) { return id < most_nodes; });
+    };
+
+    auto is_element = [](const Hanami::DOM::Node* node, std::string_view name)
+    {
+        const auto* element = dynamic_cast<const Hanami::DOM::Element*>(node);
+        return element && element->local_name == name;
+    };
+
+    // Only the div containing the edit should be rebuilt.
+    const auto* rebuilt = replace("world", "there <div>nested</div> world");
+
+    if (!is_element(rebuilt, "div") || rebuilt->children().size() != 3 || !matches_full_parse())
+    {
+        HTML_TEST_FAIL("Edit inside a div");
+    }
+
+    // Closing the div early means it no longer ends where it used to, so its parent has to be rebuilt instead.
+    rebuilt = replace("Second", "Second</div><div>Split");
+
+    if (!is_element(rebuilt, "div") || rebuilt->children().size() != 3 || !matches_full_parse())
+    {
+        HTML_TEST_FAIL("Edit closing a div");
+    }
+
+    // Renaming a start tag leaves the old end tag without a match all the way up, falling back to a full parse.
+    if (replace("<div>Third", "<section>Third") != doc || !matches_full_parse())
+    {
+        HTML_TEST_FAIL("Edit of a start tag");
+    }
+
+    // Text inserted right where an element's contents start belongs to the element, a later edit in there has to
+    // re-parse it along with the rest of the contents.
+    rebuilt = doc->reparse_range({ .offset = doc->source().find("Split"), .inserted = "Before " });
+
+    if (!is_element(rebuilt, "div") || !matches_full_parse())
+    {
+        HTML_TEST_FAIL("Insertion at the start of an element");
+    }
+
+    rebuilt = replace("Split", "Split again");
+
+    if (!is_element(rebuilt, "div") || rebuilt->children().size() != 1 || !matches_full_parse())
+    {
+        HTML_TEST_FAIL("Edit after an insertion at the start of an element");
+    }
+
+    // Enough edits for the logged shifts to be applied to every range and checkpoint in between, each one made in an
+    // element created by the previous re-parse, i.e. behind the shift of the edit that created it.
+    for (size_t i = 0; i < 100; ++i)
+    {
+        const auto* edited = i % 2 == 0 ? replace("Second", "Second<section>~</section>") : replace("~", "~~");
+
+        if (!is_element(edited, i % 2 == 0 ? "div" : "section"))
+        {
+            HTML_TEST_FAIL("Repeated edits");
+        }
+    }
+
+    if (!matches_full_parse())
+    {
+        HTML_TEST_FAIL("Repeated edits");
+    }
+
+    HTML_TEST_PASS();
+});
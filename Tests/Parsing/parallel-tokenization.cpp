@@ -0,0 +1,50 @@
+#include <fstream>
+#include <sstream>
+
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/HTML/SpeculativeTokenizer.hpp"
+
+#include "../Test.hpp"
+
+static constexpr auto test_file = "Tests/Parsing/parallel-tokenization.html";
+
+// Force parallel tokenization even for this tiny document, the result has to match a sequential parse.
+DEFINE_HTML_TEST(test_file, (Hanami::HTML::ParseOptions{ .parallel_tokenization_threshold = 0, .tokenizer_threads = 4 }),
+{
+    const auto* expected = Hanami::HTML::Parser::parse_from_file(test_file);
+
+    if (!expected)
+    {
+        HTML_TEST_FAIL("Sequential parse failed");
+    }
+
+    const bool matches = same_tree(doc, expected);
+    delete expected;
+
+    if (!matches)
+    {
+        HTML_TEST_FAIL("Parallel tokenization produced a different tree");
+    }
+
+    std::stringstream html;
+    html << std::ifstream(test_file).rdbuf();
+    const auto source = html.str();
+
+    // No split point falls inside a comment or an element whose contents aren't tokenized in the data state, whatever
+    // the case of its tag name.
+    auto is_inside = [&](size_t offset, std::string_view open, std::string_view close)
+    {
+        const auto begin = source.find(open);
+        return offset > begin && offset < source.find(close, begin);
+    };
+
+    for (const auto split_point : Hanami::HTML::find_speculative_split_points(source, source.length()))
+    {
+        if (is_inside(split_point, "<title", "</title") || is_inside(split_point, "<!--", "-->") || is_inside(split_point, "<STYLE", "</STYLE"))
+        {
+            HTML_TEST_FAIL("Split inside a comment or raw text element");
+        }
+    }
+
+    HTML_TEST_PASS();
+});
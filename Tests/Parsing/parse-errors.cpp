@@ -0,0 +1,42 @@
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+static constexpr auto test_file = "Tests/Parsing/parse-errors.html";
+
+// Reserved up front like set_parse_errors() asks for, so reporting the errors mustn't reallocate it.
+static auto errors = []
+{
+    std::vector<Hanami::HTML::ParseError> reserved;
+    reserved.reserve(16);
+    return reserved;
+}();
+
+static const auto* const reserved_errors = errors.data();
+
+DEFINE_HTML_TEST(test_file, (Hanami::HTML::ParseOptions{ .parse_errors = &errors }),
+{
+    using Hanami::HTML::ErrorType;
+
+    if (errors.size() != 2)
+    {
+        HTML_TEST_FAIL("Expected two parse errors");
+    }
+
+    if (errors.data() != reserved_errors)
+    {
+        HTML_TEST_FAIL("Expected the errors to be appended to the reserved vector");
+    }
+
+    if (errors[0].type != ErrorType::UnexpectedEqualsSignBeforeAttributeName || errors[0].offset != doc->source().find("=x"))
+    {
+        HTML_TEST_FAIL("Expected an unexpected-equals-sign-before-attribute-name error at the equals sign");
+    }
+
+    if (errors[1].type != ErrorType::MissingSemicolonAfterCharacterReference)
+    {
+        HTML_TEST_FAIL("Expected a missing-semicolon-after-character-reference error");
+    }
+
+    HTML_TEST_PASS();
+});
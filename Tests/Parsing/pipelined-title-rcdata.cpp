@@ -0,0 +1,29 @@
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+#include "WebEngine/DOM/Text.hpp"
+
+DEFINE_HTML_TEST("Tests/Parsing/pipelined-title-rcdata.html", (Hanami::HTML::ParseOptions{ .pipelined = true }),
+{
+    if (!doc->head() || doc->head()->children().empty())
+    {
+        HTML_TEST_FAIL("Parse failure");
+    }
+
+    const auto* title = dynamic_cast<const Hanami::DOM::Element*>(doc->head()->children()[0]);
+
+    if (!title || title->local_name != "title" || title->children().size() != 1)
+    {
+        HTML_TEST_FAIL("Incorrect title element");
+    }
+
+    // The tokenizer has to be in the RCDATA state for the title contents, otherwise <b> would be tokenized as a tag.
+    const auto* text = dynamic_cast<const Hanami::DOM::Text*>(title->children()[0]);
+
+    if (!text || text->whole_text() != "Fish & <b>Chips</b>")
+    {
+        HTML_TEST_FAIL("Title wasn't tokenized as RCDATA");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,40 @@
+#include "WebEngine/HTML/Parser.hpp"
+#include "WebEngine/HTML/PreloadScanner.hpp"
+
+#include "../Test.hpp"
+
+using Kind = Hanami::HTML::PreloadRequest::Kind;
+using Requests = std::vector<std::pair<Kind, std::string>>;
+
+static Hanami::HTML::PreloadQueue queue;
+
+// Nothing inside the title, script, style or comment, and the 1x (or else the first) candidate of a srcset.
+static const auto expected = Requests{
+    { Kind::Stylesheet, "style.css" },
+    { Kind::Image, "favicon.ico" },
+    { Kind::Script, "script.js" },
+    { Kind::Image, "small.png" },
+    { Kind::Image, "wide.png" },
+    { Kind::Image, "picture.webp" },
+    { Kind::Image, "picture.png" },
+    { Kind::Media, "video.mp4" },
+    { Kind::Document, "frame.html" },
+};
+
+DEFINE_HTML_TEST("Tests/Parsing/preload-scanner.html", (Hanami::HTML::ParseOptions{ .preload_queue = &queue }),
+{
+    // The queue is closed by the time parsing finishes.
+    Requests requests;
+
+    while (auto request = queue.pop())
+    {
+        requests.emplace_back(request->kind, request->url);
+    }
+
+    if (requests != expected)
+    {
+        HTML_TEST_FAIL("Wrong preload requests");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,76 @@
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+using namespace Hanami;
+
+// The elements with the given name, in tree order.
+static auto find_elements(const DOM::Node* node, std::string_view name) -> std::vector<const DOM::Element*>
+{
+    std::vector<const DOM::Element*> elements;
+
+    for (const auto* child : node->children())
+    {
+        if (const auto* element = dynamic_cast<const DOM::Element*>(child); element && element->local_name == name)
+        {
+            elements.push_back(element);
+        }
+
+        std::ranges::copy(find_elements(child, name), std::back_inserter(elements));
+    }
+
+    return elements;
+}
+
+static auto same_position(SourcePosition position, size_t line, size_t column) -> bool
+{
+    return position.line == line && position.column == column;
+}
+
+DEFINE_SIMPLE_HTML_TEST("Tests/Parsing/source-positions.html",
+{
+    const auto source = doc->source();
+    const auto divs = find_elements(doc, "div");
+    const auto paragraphs = find_elements(doc, "p");
+
+    if (divs.size() != 3 || paragraphs.size() != 1 || divs[0]->children().size() != 1)
+    {
+        HTML_TEST_FAIL("Unexpected tree");
+    }
+
+    // An element closed by its own end tag ends with it, and its text spans exactly the characters.
+    const auto first = doc->source_range(*divs[0]);
+    const auto first_text = doc->source_range(*divs[0]->children()[0]);
+
+    if (!first || first->begin != source.find("<div>First") || first->end != source.find("</div>") + 6 ||
+        !first_text || source.substr(first_text->begin, first_text->end - first_text->begin) != "First block")
+    {
+        HTML_TEST_FAIL("Wrong range of the first div");
+    }
+
+    // One that is closed implicitly ends where the token closing it starts.
+    const auto paragraph = doc->source_range(*paragraphs[0]);
+
+    if (!paragraph || paragraph->begin != source.find("<p>") || paragraph->end != source.rfind("</div>"))
+    {
+        HTML_TEST_FAIL("Wrong range of the implicitly closed paragraph");
+    }
+
+    // Columns count bytes, the nested div has two 2-byte characters before it on its line.
+    const auto nested = doc->source_range(*divs[2]);
+
+    if (!nested || !same_position(doc->source_position(nested->begin), 6, 16))
+    {
+        HTML_TEST_FAIL("Wrong position of the nested div");
+    }
+
+    if (!same_position(doc->source_position(0), 1, 1) ||
+        !same_position(doc->source_position(source.find('\n')), 1, 16) ||
+        !same_position(doc->source_position(source.find('\n') + 1), 2, 1) ||
+        !same_position(doc->source_position(source.length()), 11, 1))
+    {
+        HTML_TEST_FAIL("Wrong positions at line boundaries");
+    }
+
+    HTML_TEST_PASS();
+});
@@ -0,0 +1,75 @@
+#include <fstream>
+#include <sstream>
+
+#include "WebEngine/HTML/Parser.hpp"
+
+#include "../Test.hpp"
+
+using namespace Hanami::HTML;
+
+static constexpr auto test_file = "Tests/Parsing/tokenizer-checkpoints.html";
+
+static auto is_character_reference_state(Tokenizer::State state) -> bool
+{
+    using enum Tokenizer::State;
+    return state == CharacterReference || state == NamedCharacterReference || state == NumericCharacterReference ||
+        state == DecimalCharacterReferenceStart || state == DecimalCharacterReference || state == NumericCharacterReferenceEnd;
+}
+
+DEFINE_SIMPLE_HTML_TEST(test_file,
+{
+    std::stringstream html;
+    html << std::ifstream(test_file).rdbuf();
+    const auto source = html.str();
+
+    std::vector<std::string> expected;
+
+    Tokenizer uninterrupted;
+    uninterrupted.start(source, [&](const Token& token) { expected.push_back(describe_token(token)); });
+
+    // Take a checkpoint after every step of the state machine, and finish the input from it in another tokenizer.
+    size_t mid_token = 0;
+    size_t mid_attribute_reference = 0;
+
+    for (size_t steps = 1;; ++steps)
+    {
+        std::vector<std::string> tokens;
+        auto emit = [&](const Token& token) { tokens.push_back(describe_token(token)); };
+
+        Tokenizer interrupted;
+        interrupted.reset(source, emit);
+
+        bool reached_eof = false;
+
+        for (size_t i = 0; i < steps && !reached_eof; ++i)
+        {
+            reached_eof = interrupted.step();
+        }
+
+        if (reached_eof)
+        {
+            break;
+        }
+
+        const auto checkpoint = interrupted.checkpoint();
+
+        mid_token += checkpoint.token_in_progress != nullptr;
+        mid_attribute_reference += is_character_reference_state(checkpoint.state) && checkpoint.return_state != Tokenizer::State::Data;
+
+        Tokenizer resumed;
+        resumed.reset(source, emit);
+        resumed.restore(checkpoint);
+
+        if (!resumed.run_until(source.length()) || tokens != expected)
+        {
+            HTML_TEST_FAIL("Tokens after restoring a checkpoint differ");
+        }
+    }
+
+    if (mid_token == 0 || mid_attribute_reference == 0)
+    {
+        HTML_TEST_FAIL("No checkpoints were taken in the middle of a token");
+    }
+
+    HTML_TEST_PASS();
+});
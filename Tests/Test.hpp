@@ -1,17 +1,121 @@
 #pragma once
 
 #include <print>
+#include <algorithm>
+
+#include "WebEngine/DOM/Element.hpp"
+#include "WebEngine/DOM/CharacterData.hpp"
+#include "WebEngine/HTML/Tokenizer.hpp"
+#include "WebEngine/Layout/LayoutTree.hpp"
 
 #define HTML_TEST_FAIL(msg) status = -1; return
 #define HTML_TEST_PASS() status = 0; return
 
-#define DEFINE_SIMPLE_HTML_TEST(file, test)\
+#define DEFINE_HTML_TEST(file, options, test)\
     int main()\
     {\
-        const auto* doc = Hanami::HTML::Parser::parse_from_file(file);\
+        auto* doc = Hanami::HTML::Parser::parse_from_file(file, options);\
         if (!doc) { return -1; }\
         int status = -1;\
         [&] test();\
         delete doc;\
         return status;\
     }
+
+#define DEFINE_SIMPLE_HTML_TEST(file, test) DEFINE_HTML_TEST(file, {}, test)
+
+// Compares node types, element names and character data, recursively.
+inline auto same_tree(const Hanami::DOM::Node* a, const Hanami::DOM::Node* b) -> bool
+{
+    if (a->type() != b->type() || a->children().size() != b->children().size())
+    {
+        return false;
+    }
+
+    const auto* a_elem = dynamic_cast<const Hanami::DOM::Element*>(a);
+    const auto* b_elem = dynamic_cast<const Hanami::DOM::Element*>(b);
+
+    if (a_elem && b_elem && a_elem->local_name != b_elem->local_name)
+    {
+        return false;
+    }
+
+    const auto* a_cdata = dynamic_cast<const Hanami::DOM::CharacterData*>(a);
+    const auto* b_cdata = dynamic_cast<const Hanami::DOM::CharacterData*>(b);
+
+    if (a_cdata && b_cdata && a_cdata->data() != b_cdata->data())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < a->children().size(); ++i)
+    {
+        if (!same_tree(a->children()[i], b->children()[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Enough of a token to tell two token streams apart.
+inline auto describe_token(const Hanami::HTML::Token& token) -> std::string
+{
+    using namespace Hanami::HTML;
+
+    auto describe_tag = [](const TagToken& tag) -> std::string
+    {
+        auto result = tag.name;
+
+        for (const auto& attribute : tag.attributes)
+        {
+            result += " " + attribute.name + "=" + attribute.value;
+        }
+
+        return tag.self_closing ? result + "/" : result;
+    };
+
+    return std::visit(Kori::VariantOverloadSet {
+        [](const DOCTYPEToken& doctype) -> std::string
+        {
+            return "!" + doctype.name + " " + doctype.public_identifier.value_or("-") + " " +
+                doctype.system_identifier.value_or("-") + (doctype.force_quirks ? " quirks" : "");
+        },
+        [&](const StartTagToken& tag) -> std::string { return "<" + describe_tag(tag); },
+        [&](const EndTagToken& tag) -> std::string { return "</" + describe_tag(tag); },
+        [](const CommentToken& comment) -> std::string { return "--" + comment.data; },
+        [](const CharacterToken& character) -> std::string { return std::string(1, character.data); },
+        [](const EOFToken&) -> std::string { return "EOF"; },
+    }, token);
+}
+
+// Layout tests measure every code point as 10 wide, with lines 20 high.
+inline auto measure_test_text(std::string_view text) -> double
+{
+    return 10.0 * static_cast<double>(std::ranges::count_if(text, [](char c) { return (c & 0xC0) != 0x80; }));
+}
+
+inline auto test_layout_options(uint32_t thread_count = 1) -> Hanami::Layout::LayoutOptions
+{
+    return { .font_size = 20.0, .line_height = 1.0, .thread_count = thread_count };
+}
+
+// The boxes of the children of the body, which is the only box in the html element's.
+inline auto body_boxes(const Hanami::Layout::LayoutTree& tree) -> std::span<const std::unique_ptr<Hanami::Layout::Box>>
+{
+    return tree.root()->children()[0]->children()[0]->children();
+}
+
+// Where the box is relative to the root box.
+inline auto page_y(const Hanami::Layout::Box& box) -> double
+{
+    double y = 0.0;
+
+    for (const auto* ancestor = &box; ancestor; ancestor = ancestor->parent())
+    {
+        y += ancestor->y();
+    }
+
+    return y;
+}